@@ -0,0 +1,498 @@
+#include <bench/bench_baseline.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+// ============================================================================
+// Just enough JSON to read back what save_baseline writes (and the hand
+// edits of it): objects, arrays, strings, numbers, true / false / null
+struct json_value
+{
+    enum kind_t { null_value, boolean, number, string, array, object };
+
+    kind_t kind = null_value;
+    double value = 0.0;
+    std::string text;
+    std::vector<json_value> items;
+    std::vector<std::pair<std::string, json_value>> members;
+
+    json_value const* find(std::string const& name) const
+    {
+        for (auto const& member : members) {
+            if (member.first == name) {
+                return &member.second;
+            }
+        }
+        return nullptr;
+    }
+};
+// ----------------------------------------------------------------------------
+class json_parser
+{
+public:
+    explicit json_parser(std::string const& text) : text(text), position(0) {}
+
+    json_value parse()
+    {
+        json_value value(parse_value());
+        skip_space();
+        if (position != text.size()) {
+            fail("trailing characters");
+        }
+        return value;
+    }
+
+private:
+    [[noreturn]] void fail(char const* what) const
+    {
+        throw std::runtime_error("Malformed baseline: " + std::string(what)
+            + " at offset " + std::to_string(position));
+    }
+
+    void skip_space()
+    {
+        while ((position < text.size())
+            && ((text[position] == ' ') || (text[position] == '\t')
+                || (text[position] == '\n') || (text[position] == '\r'))) {
+            ++position;
+        }
+    }
+
+    bool accept(char c)
+    {
+        skip_space();
+        if ((position < text.size()) && (text[position] == c)) {
+            ++position;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char c)
+    {
+        if (!accept(c)) {
+            fail("unexpected character");
+        }
+    }
+
+    bool accept_word(char const* word)
+    {
+        std::string const w(word);
+        if (text.compare(position, w.size(), w) == 0) {
+            position += w.size();
+            return true;
+        }
+        return false;
+    }
+
+    std::string parse_string()
+    {
+        expect('"');
+        std::string result;
+        while (true) {
+            if (position >= text.size()) {
+                fail("unterminated string");
+            }
+            char c(text[position++]);
+            if (c == '"') {
+                return result;
+            }
+            if (c == '\\') {
+                if (position >= text.size()) {
+                    fail("unterminated string");
+                }
+                c = text[position++];
+                switch (c) {
+                case 'n': c = '\n'; break;
+                case 't': c = '\t'; break;
+                case 'r': c = '\r'; break;
+                case 'b': c = '\b'; break;
+                case 'f': c = '\f'; break;
+                case 'u':
+                    // Only ever used here for odd CPU names, kept as a marker
+                    position += 4;
+                    c = '?';
+                    break;
+                }
+            }
+            result += c;
+        }
+    }
+
+    json_value parse_value()
+    {
+        json_value value;
+        skip_space();
+        if (position >= text.size()) {
+            fail("unexpected end");
+        }
+
+        char const c(text[position]);
+        if (c == '{') {
+            value.kind = json_value::object;
+            ++position;
+            if (!accept('}')) {
+                do {
+                    skip_space();
+                    std::string name(parse_string());
+                    expect(':');
+                    value.members.emplace_back(std::move(name), parse_value());
+                } while (accept(','));
+                expect('}');
+            }
+        } else if (c == '[') {
+            value.kind = json_value::array;
+            ++position;
+            if (!accept(']')) {
+                do {
+                    value.items.push_back(parse_value());
+                } while (accept(','));
+                expect(']');
+            }
+        } else if (c == '"') {
+            value.kind = json_value::string;
+            value.text = parse_string();
+        } else if (accept_word("true")) {
+            value.kind = json_value::boolean;
+            value.value = 1.0;
+        } else if (accept_word("false")) {
+            value.kind = json_value::boolean;
+        } else if (accept_word("null")) {
+            value.kind = json_value::null_value;
+        } else {
+            char const* start(text.c_str() + position);
+            char* end(nullptr);
+            value.kind = json_value::number;
+            value.value = std::strtod(start, &end);
+            if (end == start) {
+                fail("unexpected character");
+            }
+            position += static_cast<size_t>(end - start);
+        }
+        return value;
+    }
+
+private:
+    std::string const& text;
+    size_t position;
+};
+// ----------------------------------------------------------------------------
+static std::string const& json_string(json_value const& entry, char const* name)
+{
+    json_value const* value(entry.find(name));
+    if (!value || (value->kind != json_value::string)) {
+        throw std::runtime_error(std::string("Malformed baseline: missing ") + name);
+    }
+    return value->text;
+}
+// ----------------------------------------------------------------------------
+static double json_number(json_value const& entry, char const* name)
+{
+    json_value const* value(entry.find(name));
+    if (!value || (value->kind != json_value::number)) {
+        throw std::runtime_error(std::string("Malformed baseline: missing ") + name);
+    }
+    return value->value;
+}
+// ----------------------------------------------------------------------------
+static void write_json_string(std::ostream& output, std::string const& text)
+{
+    output << '"';
+    for (char c : text) {
+        if ((c == '"') || (c == '\\')) {
+            output << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            output << ' ';
+        } else {
+            output << c;
+        }
+    }
+    output << '"';
+}
+// ============================================================================
+std::string cpu_model()
+{
+#if defined(__linux__)
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+        // "model name" on x86, "Processor" on older arm kernels
+        if ((line.compare(0, 10, "model name") == 0) || (line.compare(0, 9, "Processor") == 0)) {
+            size_t const colon(line.find(':'));
+            if (colon != std::string::npos) {
+                size_t const first(line.find_first_not_of(" \t", colon + 1));
+                if (first != std::string::npos) {
+                    return line.substr(first);
+                }
+            }
+        }
+    }
+#endif
+    return "unknown";
+}
+// ----------------------------------------------------------------------------
+std::vector<baseline_entry> load_baseline(std::string const& path)
+{
+    std::vector<baseline_entry> entries;
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return entries;
+    }
+    std::ostringstream buffer;
+    buffer << file.rdbuf();
+    std::string const text(buffer.str());
+
+    json_value const root(json_parser(text).parse());
+    json_value const* list(root.find("baselines"));
+    if (!list || (list->kind != json_value::array)) {
+        throw std::runtime_error("Malformed baseline: no baselines in " + path);
+    }
+
+    for (json_value const& item : list->items) {
+        baseline_entry entry;
+        entry.cpu = json_string(item, "cpu");
+        entry.codec = json_string(item, "codec");
+        entry.workload = json_string(item, "workload");
+        entry.universe = static_cast<uint64_t>(json_number(item, "universe"));
+        entry.match_count = static_cast<uint32_t>(json_number(item, "match_count"));
+        entry.operation = json_string(item, "operation");
+        entry.compressed_bytes = json_number(item, "compressed_bytes");
+
+        json_value const* samples(item.find("samples_ns"));
+        if (!samples || (samples->kind != json_value::array)) {
+            throw std::runtime_error("Malformed baseline: missing samples_ns");
+        }
+        for (json_value const& sample : samples->items) {
+            entry.samples_ns.push_back(static_cast<uint64_t>(sample.value));
+        }
+        entries.push_back(entry);
+    }
+    return entries;
+}
+// ----------------------------------------------------------------------------
+void save_baseline(std::string const& path
+    , std::string const& cpu
+    , std::vector<bench_result> const& results)
+{
+    std::vector<baseline_entry> entries(load_baseline(path));
+    entries.erase(std::remove_if(entries.begin(), entries.end(), [&](baseline_entry const& e) {
+        return e.cpu == cpu;
+    }), entries.end());
+
+    for (bench_result const& r : results) {
+        baseline_entry entry;
+        entry.cpu = cpu;
+        entry.codec = r.codec;
+        entry.workload = r.workload;
+        entry.universe = r.universe;
+        entry.match_count = r.match_count;
+        entry.operation = r.operation;
+        entry.compressed_bytes = r.compressed_bytes;
+        entry.samples_ns = r.samples_ns;
+        entries.push_back(entry);
+    }
+
+    // Written aside and renamed, a failed run leaves the old baseline intact
+    std::string const temporary(path + ".tmp");
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            throw std::runtime_error("Unable to create " + temporary);
+        }
+        // Mean sizes must read back exactly
+        file.precision(std::numeric_limits<double>::max_digits10);
+        file << "{\"baselines\": [";
+        for (size_t i(0); i < entries.size(); ++i) {
+            baseline_entry const& e(entries[i]);
+            file << (i ? ",\n" : "\n") << "  {\"cpu\": ";
+            write_json_string(file, e.cpu);
+            file << ", \"codec\": ";
+            write_json_string(file, e.codec);
+            file << ", \"workload\": ";
+            write_json_string(file, e.workload);
+            file << ", \"universe\": " << e.universe
+                << ", \"match_count\": " << e.match_count
+                << ", \"operation\": ";
+            write_json_string(file, e.operation);
+            file << ", \"compressed_bytes\": " << e.compressed_bytes
+                << ", \"samples_ns\": [";
+            for (size_t j(0); j < e.samples_ns.size(); ++j) {
+                file << (j ? "," : "") << e.samples_ns[j];
+            }
+            file << "]}";
+        }
+        file << "\n]}\n";
+        if (!file.flush()) {
+            throw std::runtime_error("Unable to write " + temporary);
+        }
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(path.c_str());
+        if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+            throw std::runtime_error("Unable to replace " + path);
+        }
+    }
+}
+// ============================================================================
+// Relative slack of the size check, means round in their last digit
+static double const SIZE_TOLERANCE(1e-9);
+// ----------------------------------------------------------------------------
+double mann_whitney_p(std::vector<uint64_t> const& baseline, std::vector<uint64_t> const& current)
+{
+    if (baseline.empty() || current.empty()) {
+        return 1.0;
+    }
+
+    // (value, from current), ranked together
+    std::vector<std::pair<uint64_t, bool>> all;
+    all.reserve(baseline.size() + current.size());
+    for (uint64_t v : baseline) {
+        all.emplace_back(v, false);
+    }
+    for (uint64_t v : current) {
+        all.emplace_back(v, true);
+    }
+    std::sort(all.begin(), all.end());
+
+    double const n1(static_cast<double>(baseline.size()));
+    double const n2(static_cast<double>(current.size()));
+    double const n(n1 + n2);
+
+    // Tied values share the mean of their ranks
+    double rank_sum(0.0);
+    double tie_term(0.0);
+    size_t first(0);
+    while (first < all.size()) {
+        size_t last(first + 1);
+        while ((last < all.size()) && (all[last].first == all[first].first)) {
+            ++last;
+        }
+        double const mean_rank(0.5 * double(first + 1 + last));
+        for (size_t i(first); i < last; ++i) {
+            if (all[i].second) {
+                rank_sum += mean_rank;
+            }
+        }
+        double const t(static_cast<double>(last - first));
+        tie_term += t * t * t - t;
+        first = last;
+    }
+
+    double const u(rank_sum - n2 * (n2 + 1.0) / 2.0);
+    double const mean(n1 * n2 / 2.0);
+    double const variance(n1 * n2 / 12.0 * ((n + 1.0) - tie_term / (n * (n - 1.0))));
+    if (variance <= 0.0) {
+        return 1.0;
+    }
+
+    // Continuity corrected, upper tail
+    double const z((u - mean - 0.5) / std::sqrt(variance));
+    return 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+// ----------------------------------------------------------------------------
+static double median(std::vector<uint64_t> samples)
+{
+    if (samples.empty()) {
+        return 0.0;
+    }
+    size_t const middle(samples.size() / 2);
+    std::nth_element(samples.begin(), samples.begin() + middle, samples.end());
+    return double(samples[middle]);
+}
+// ----------------------------------------------------------------------------
+std::vector<regression_check> check_regressions(std::vector<baseline_entry> const& baseline
+    , std::string const& cpu
+    , std::vector<bench_result> const& results
+    , regression_options const& options)
+{
+    std::vector<regression_check> checks;
+    for (bench_result const& r : results) {
+        auto const found(std::find_if(baseline.begin(), baseline.end(), [&](baseline_entry const& e) {
+            return (e.cpu == cpu)
+                && (e.codec == r.codec)
+                && (e.workload == r.workload)
+                && (e.universe == r.universe)
+                && (e.match_count == r.match_count)
+                && (e.operation == r.operation);
+        }));
+        if (found == baseline.end()) {
+            continue;
+        }
+
+        regression_check check;
+        check.codec = r.codec;
+        check.workload = r.workload;
+        check.universe = r.universe;
+        check.match_count = r.match_count;
+        check.operation = r.operation;
+        check.baseline_bytes = found->compressed_bytes;
+        check.current_bytes = r.compressed_bytes;
+        check.baseline_p50_ns = median(found->samples_ns);
+        check.current_p50_ns = median(r.samples_ns);
+        check.p_value = mann_whitney_p(found->samples_ns, r.samples_ns);
+
+        check.size_regression = check.current_bytes
+            > check.baseline_bytes * (1.0 + SIZE_TOLERANCE);
+        check.speed_regression = (check.p_value < options.alpha)
+            && (check.current_p50_ns > check.baseline_p50_ns * (1.0 + options.max_slowdown));
+        checks.push_back(check);
+    }
+    return checks;
+}
+// ----------------------------------------------------------------------------
+size_t write_regressions(std::ostream& output, std::vector<regression_check> const& checks)
+{
+    std::ios::fmtflags const flags(output.flags());
+    std::streamsize const precision(output.precision(2));
+    output << std::fixed;
+
+    output << std::left
+        << std::setw(14) << "codec"
+        << std::setw(11) << "workload"
+        << std::right
+        << std::setw(10) << "matches"
+        << std::setw(12) << "operation"
+        << std::setw(14) << "bytes"
+        << std::setw(14) << "p50 ns"
+        << std::setw(10) << "change"
+        << std::setw(10) << "p"
+        << "  verdict\n";
+
+    size_t regressions(0);
+    for (regression_check const& c : checks) {
+        double const change((c.baseline_p50_ns > 0.0)
+            ? 100.0 * (c.current_p50_ns / c.baseline_p50_ns - 1.0)
+            : 0.0);
+        output << std::left
+            << std::setw(14) << c.codec
+            << std::setw(11) << c.workload
+            << std::right
+            << std::setw(10) << c.match_count
+            << std::setw(12) << c.operation
+            << std::setw(14) << c.current_bytes
+            << std::setw(14) << c.current_p50_ns
+            << std::setw(9) << change << "%"
+            << std::setw(10) << std::setprecision(4) << c.p_value << std::setprecision(2)
+            << "  ";
+        if (c.size_regression || c.speed_regression) {
+            ++regressions;
+            output << (c.size_regression ? "SIZE " : "") << (c.speed_regression ? "SPEED " : "")
+                << "REGRESSION";
+        } else {
+            output << "ok";
+        }
+        output << "\n";
+    }
+
+    output.precision(precision);
+    output.flags(flags);
+    return regressions;
+}
+// ============================================================================
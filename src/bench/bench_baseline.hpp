@@ -0,0 +1,84 @@
+#pragma once
+// ============================================================================
+#include <bench/bench_report.hpp>
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+// ============================================================================
+// Benchmark results kept for later runs to be compared against.
+//
+// A baseline file is JSON and holds runs of any number of machines, keyed by
+// CPU model: timings only compare on the same hardware. Saving replaces the
+// entries of the current CPU and keeps the others.
+//
+//   {"baselines": [
+//     {"cpu": "...", "codec": "...", "workload": "...", "universe": n,
+//      "match_count": n, "operation": "...", "compressed_bytes": x,
+//      "samples_ns": [...]},
+//     ...]}
+// ============================================================================
+struct baseline_entry
+{
+    std::string cpu;
+    std::string codec;
+    std::string workload;
+    uint64_t universe;
+    uint32_t match_count;
+    std::string operation;
+    double compressed_bytes;
+    std::vector<uint64_t> samples_ns;
+};
+
+// Model name of the processor, "unknown" where it can't be read
+std::string cpu_model();
+
+// Missing file = no entries, throws on malformed ones
+std::vector<baseline_entry> load_baseline(std::string const& path);
+// Merges `results` as the entries of `cpu` into the file
+void save_baseline(std::string const& path
+    , std::string const& cpu
+    , std::vector<bench_result> const& results);
+// ============================================================================
+struct regression_options
+{
+    // One sided significance level of the Mann-Whitney U test
+    double alpha = 0.01;
+    // Median slowdown below which a significant difference is still noise
+    double max_slowdown = 0.05;
+};
+// ----------------------------------------------------------------------------
+struct regression_check
+{
+    std::string codec;
+    std::string workload;
+    uint64_t universe;
+    uint32_t match_count;
+    std::string operation;
+
+    double baseline_bytes;
+    double current_bytes;
+    double baseline_p50_ns;
+    double current_p50_ns;
+    // P(current is not slower), Mann-Whitney U, normal approximation
+    double p_value;
+
+    // Lists are generated from a fixed seed, so any growth is real
+    bool size_regression;
+    bool speed_regression;
+};
+// ----------------------------------------------------------------------------
+// Mann-Whitney U test that `current` tends to be larger than `baseline`,
+// one sided, tie corrected. Returns the p-value, 1 for empty samples
+double mann_whitney_p(std::vector<uint64_t> const& baseline, std::vector<uint64_t> const& current);
+
+// Checks the results that have a baseline entry of `cpu`, others are skipped
+std::vector<regression_check> check_regressions(std::vector<baseline_entry> const& baseline
+    , std::string const& cpu
+    , std::vector<bench_result> const& results
+    , regression_options const& options);
+
+// Aligned text table, returns the number of regressions
+size_t write_regressions(std::ostream& output, std::vector<regression_check> const& checks);
+// ============================================================================
@@ -0,0 +1,93 @@
+#include <bench/bench_codecs.hpp>
+
+#include <bslc/arithmetic_codec_v1.hpp>
+#include <bslc/arithmetic_codec_v2.hpp>
+#include <bslc/bzip2_codec.hpp>
+#include <bslc/gap_codec.hpp>
+#include <bslc/interleaved_codec.hpp>
+#include <bslc/mixing_codec.hpp>
+#include <bslc/ppm_gap_codec.hpp>
+#include <bslc/segmented_codec.hpp>
+#include <bslc/snappy_codec.hpp>
+#include <bslc/static_gap_codec.hpp>
+#include <bslc/template_codec.hpp>
+#include <bslc/trained_gap_codec.hpp>
+#include <bslc/zlib_codec.hpp>
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+// ============================================================================
+template <typename Codec, typename... Args>
+static codec_factory make_factory(std::string const& name, Args... args)
+{
+    codec_factory factory;
+    factory.name = name;
+    factory.make = [args...](uint64_t universe) -> std::unique_ptr<bench_codec> {
+        return std::unique_ptr<bench_codec>(new bench_codec_impl<Codec>(args..., universe));
+    };
+    return factory;
+}
+// ============================================================================
+std::vector<codec_factory> const& bench_codecs()
+{
+    static std::vector<codec_factory> const codecs = {
+        make_factory<arithmetic_codec_v1>("arith_v1"),
+        make_factory<arithmetic_codec_v2>("arith_v2"),
+        make_factory<mixing_codec>("mixing"),
+        make_factory<zlib_codec>("zlib", uint32_t(4)),
+        make_factory<bzip2_codec>("bzip2", uint32_t(4)),
+        make_factory<snappy_codec>("snappy", uint32_t(1)),
+        make_factory<interleaved_codec>("interleaved", uint32_t(4)),
+        // Single threaded, the scaling with threads is measured separately
+        make_factory<segmented_codec>("segmented", uint32_t(16), static_cast<thread_pool*>(nullptr)),
+        make_factory<gap_codec>("gap"),
+        make_factory<static_gap_codec>("static_gap"),
+        make_factory<ppm_gap_codec>("ppm_gap", uint32_t(1)),
+        make_factory<template_codec>("template_1d", uint32_t(0)),
+        // Rows of a 1000 x 1000 grid at the default universe
+        make_factory<template_codec>("template_2d", uint32_t(1000)),
+    };
+    return codecs;
+}
+// ----------------------------------------------------------------------------
+std::vector<codec_factory> select_codecs(std::string const& names)
+{
+    std::vector<codec_factory> const& codecs(bench_codecs());
+    if (names.empty()) {
+        return codecs;
+    }
+
+    std::vector<codec_factory> result;
+    std::istringstream stream(names);
+    std::string name;
+    while (std::getline(stream, name, ',')) {
+        bool found(false);
+        for (codec_factory const& factory : codecs) {
+            if (factory.name == name) {
+                result.push_back(factory);
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            throw std::runtime_error("Unknown codec: " + name);
+        }
+    }
+    return result;
+}
+// ----------------------------------------------------------------------------
+codec_factory trained_gap_factory(std::shared_ptr<gap_models const> models)
+{
+    codec_factory factory;
+    factory.name = "trained_gap";
+    factory.make = [models](uint64_t universe) -> std::unique_ptr<bench_codec> {
+        if (universe != models->universe()) {
+            throw std::runtime_error("Gap models were trained on universe "
+                + std::to_string(models->universe()) + ", not " + std::to_string(universe) + ".");
+        }
+        return std::unique_ptr<bench_codec>(new bench_codec_impl<trained_gap_codec>(*models));
+    };
+    return factory;
+}
+// ============================================================================
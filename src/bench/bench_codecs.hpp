@@ -0,0 +1,72 @@
+#pragma once
+// ============================================================================
+#include <bslc/span.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+// ============================================================================
+class gap_models;
+// ============================================================================
+// Type erased span interface of a codec, so the drivers can loop over all of
+// them. One virtual call per list is noise next to the work of any codec.
+class bench_codec
+{
+public:
+    virtual ~bench_codec() {}
+
+    virtual size_t max_compressed_size(uint32_t match_count) const = 0;
+    virtual size_t decompressed_size(span<uint8_t const> compressed) = 0;
+
+    virtual size_t compress_into(span<uint32_t const> matches, span<uint8_t> compressed) = 0;
+    virtual size_t decompress_into(span<uint8_t const> compressed, span<uint32_t> matches) = 0;
+};
+// ----------------------------------------------------------------------------
+template <typename Codec>
+class bench_codec_impl
+    : public bench_codec
+{
+public:
+    template <typename... Args>
+    explicit bench_codec_impl(Args const&... args) : codec(args...) {}
+
+    size_t max_compressed_size(uint32_t match_count) const override
+    {
+        return codec.max_compressed_size(match_count);
+    }
+    size_t decompressed_size(span<uint8_t const> compressed) override
+    {
+        return codec.decompressed_size(compressed);
+    }
+    size_t compress_into(span<uint32_t const> matches, span<uint8_t> compressed) override
+    {
+        return codec.compress_into(matches, compressed);
+    }
+    size_t decompress_into(span<uint8_t const> compressed, span<uint32_t> matches) override
+    {
+        return codec.decompress_into(compressed, matches);
+    }
+
+    Codec& get() { return codec; }
+
+private:
+    Codec codec;
+};
+// ============================================================================
+struct codec_factory
+{
+    std::string name;
+    // Codec for lists of the given universe
+    std::function<std::unique_ptr<bench_codec>(uint64_t universe)> make;
+};
+
+// Every codec of the library in its default configuration
+std::vector<codec_factory> const& bench_codecs();
+// Subset named in a comma separated list ("" = all), throws on unknown names
+std::vector<codec_factory> select_codecs(std::string const& names);
+// "trained_gap" with a loaded model file, not part of the defaults. Makes
+// codecs of the models' universe only, throws on others
+codec_factory trained_gap_factory(std::shared_ptr<gap_models const> models);
+// ============================================================================
@@ -0,0 +1,449 @@
+#include <bench/bench_baseline.hpp>
+#include <bench/bench_codecs.hpp>
+#include <bench/bench_pareto.hpp>
+#include <bench/bench_report.hpp>
+#include <bench/bench_runner.hpp>
+#include <bench/bench_scaling.hpp>
+#include <bench/perf_counters.hpp>
+
+#include <bslc/corpus.hpp>
+#include <bslc/gap_models.hpp>
+#include <bslc/match_list.hpp>
+#include <bslc/workload.hpp>
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+// ============================================================================
+static char const* const USAGE =
+    "Usage: bslc_bench [options]\n"
+    "  --codecs a,b,...     codecs to run (default: all)\n"
+    "  --workloads a,b,...  uniform, clustered, bursty, periodic, zipf (default: uniform)\n"
+    "  --sizes n,m,...      match counts (default: gen_test_sizes)\n"
+    "  --universe n         number of possible values (default: 1000000)\n"
+    "  --lists n            distinct lists per size (default: 8)\n"
+    "  --warmup n           untimed calls per operation (default: 8)\n"
+    "  --iterations n       timed calls per operation (default: 64)\n"
+    "  --seed n             workload seed (default: 1)\n"
+    "  --corpus path        benchmark the lists of a corpus file instead\n"
+    "  --models path        also run trained_gap with this gap model file\n"
+    "  --train-models path  train gap models on the --corpus lists of --universe,\n"
+    "                       write them to path and exit\n"
+    "  --model-id n         ID the trained models are stored under (default: 1)\n"
+    "  --perf               add hardware counters (IPC, misses per element)\n"
+    "  --scaling            aggregate throughput over thread counts and working sets\n"
+    "  --threads n,m,...    thread counts of --scaling (default: 1, 2, 4, ... cores)\n"
+    "  --working-sets a,... uncompressed bytes of --scaling, k/m/g suffixes allowed\n"
+    "                       (default: 16k,256k,4m,64m)\n"
+    "  --pareto             size vs. the log2 C(N, n) bound and speed per codec and\n"
+    "                       density, flags the Pareto optimal codecs\n"
+    "  --table path         --pareto: optimal set per density as a text table\n"
+    "                       (default: stderr)\n"
+    "  --save-baseline path store the results as this CPU's baseline\n"
+    "  --baseline path      compare against this CPU's baseline, exit status 2 on a\n"
+    "                       size regression or a significant slowdown\n"
+    "  --alpha p            significance level of the comparison (default: 0.01)\n"
+    "  --max-slowdown f     median slowdown tolerated (default: 0.05)\n"
+    "  --format csv|json    report format (default: csv)\n"
+    "  --output path        report file (default: stdout)\n";
+// ----------------------------------------------------------------------------
+struct driver_options
+{
+    std::string codecs;
+    std::vector<workload_kind> workloads;
+    std::vector<uint32_t> sizes;
+    uint64_t universe = NUM_VALUES;
+    uint32_t list_count = 8;
+    uint64_t seed = 1;
+    std::string corpus;
+    std::string models;
+    std::string train_models;
+    uint32_t model_id = 1;
+    report_format format = report_format::csv;
+    std::string output;
+    bool perf = false;
+    bench_options bench;
+    bool scaling = false;
+    scaling_options sweep;
+    bool pareto = false;
+    std::string table;
+    std::string save_baseline;
+    std::string baseline;
+    regression_options regression;
+};
+// ============================================================================
+static uint64_t parse_number(std::string const& text)
+{
+    size_t used(0);
+    unsigned long long value(std::stoull(text, &used));
+    if (used != text.size()) {
+        throw std::runtime_error("Invalid number: " + text);
+    }
+    return value;
+}
+// ----------------------------------------------------------------------------
+static double parse_fraction(std::string const& text)
+{
+    size_t used(0);
+    double const value(std::stod(text, &used));
+    if ((used != text.size()) || !(value >= 0.0)) {
+        throw std::runtime_error("Invalid number: " + text);
+    }
+    return value;
+}
+// ----------------------------------------------------------------------------
+// Bytes, with an optional binary k / m / g suffix
+static uint64_t parse_bytes(std::string const& text)
+{
+    if (text.empty()) {
+        throw std::runtime_error("Invalid size: " + text);
+    }
+    uint32_t shift(0);
+    switch (text.back()) {
+    case 'k': case 'K': shift = 10; break;
+    case 'm': case 'M': shift = 20; break;
+    case 'g': case 'G': shift = 30; break;
+    }
+    return parse_number(shift ? text.substr(0, text.size() - 1) : text) << shift;
+}
+// ----------------------------------------------------------------------------
+static std::vector<std::string> split_list(std::string const& text)
+{
+    std::vector<std::string> items;
+    std::istringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        items.push_back(item);
+    }
+    return items;
+}
+// ----------------------------------------------------------------------------
+static driver_options parse_arguments(int argc, char* argv[])
+{
+    driver_options options;
+    options.workloads.push_back(workload_kind::uniform);
+
+    for (int i(1); i < argc; ++i) {
+        std::string const name(argv[i]);
+        if ((name == "--help") || (name == "-h")) {
+            std::cout << USAGE;
+            std::exit(0);
+        }
+        if (name == "--perf") {
+            options.perf = true;
+            continue;
+        }
+        if (name == "--scaling") {
+            options.scaling = true;
+            continue;
+        }
+        if (name == "--pareto") {
+            options.pareto = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            throw std::runtime_error("Missing value for " + name);
+        }
+        std::string const value(argv[++i]);
+
+        if (name == "--codecs") {
+            options.codecs = value;
+        } else if (name == "--workloads") {
+            options.workloads.clear();
+            for (std::string const& item : split_list(value)) {
+                options.workloads.push_back(parse_workload_kind(item));
+            }
+        } else if (name == "--sizes") {
+            for (std::string const& item : split_list(value)) {
+                options.sizes.push_back(static_cast<uint32_t>(parse_number(item)));
+            }
+        } else if (name == "--universe") {
+            options.universe = parse_number(value);
+        } else if (name == "--lists") {
+            options.list_count = static_cast<uint32_t>(parse_number(value));
+        } else if (name == "--warmup") {
+            options.bench.warmup = static_cast<uint32_t>(parse_number(value));
+        } else if (name == "--iterations") {
+            options.bench.iterations = static_cast<uint32_t>(parse_number(value));
+        } else if (name == "--seed") {
+            options.seed = parse_number(value);
+        } else if (name == "--corpus") {
+            options.corpus = value;
+        } else if (name == "--models") {
+            options.models = value;
+        } else if (name == "--train-models") {
+            options.train_models = value;
+        } else if (name == "--model-id") {
+            options.model_id = static_cast<uint32_t>(parse_number(value));
+        } else if (name == "--threads") {
+            for (std::string const& item : split_list(value)) {
+                options.sweep.thread_counts.push_back(static_cast<uint32_t>(parse_number(item)));
+            }
+        } else if (name == "--working-sets") {
+            for (std::string const& item : split_list(value)) {
+                options.sweep.working_sets.push_back(parse_bytes(item));
+            }
+        } else if (name == "--format") {
+            options.format = parse_report_format(value);
+        } else if (name == "--save-baseline") {
+            options.save_baseline = value;
+        } else if (name == "--baseline") {
+            options.baseline = value;
+        } else if (name == "--alpha") {
+            options.regression.alpha = parse_fraction(value);
+        } else if (name == "--max-slowdown") {
+            options.regression.max_slowdown = parse_fraction(value);
+        } else if (name == "--table") {
+            options.table = value;
+        } else if (name == "--output") {
+            options.output = value;
+        } else {
+            throw std::runtime_error("Unknown option: " + name);
+        }
+    }
+
+    if (options.sizes.empty()) {
+        options.sizes = gen_test_sizes();
+    }
+    if ((options.list_count == 0) || (options.bench.iterations == 0)) {
+        throw std::runtime_error("Need at least one list and one iteration.");
+    }
+    if (options.scaling && options.pareto) {
+        throw std::runtime_error("--scaling and --pareto are exclusive.");
+    }
+    if (options.scaling && (!options.baseline.empty() || !options.save_baseline.empty())) {
+        throw std::runtime_error("Baselines hold latency runs, not --scaling ones.");
+    }
+    if (!options.train_models.empty() && options.corpus.empty()) {
+        throw std::runtime_error("--train-models needs a --corpus.");
+    }
+    if (options.sweep.thread_counts.empty()) {
+        options.sweep.thread_counts = default_thread_counts();
+    }
+    if (options.sweep.working_sets.empty()) {
+        options.sweep.working_sets = default_working_sets();
+    }
+    options.sweep.iterations = options.bench.iterations;
+    check_universe(options.universe);
+    return options;
+}
+// ============================================================================
+// Lists to benchmark together: same workload, universe and size
+struct list_group
+{
+    std::string workload;
+    uint64_t universe;
+    std::vector<span<uint32_t const>> lists;
+};
+// ----------------------------------------------------------------------------
+static void run_groups(std::vector<codec_factory> const& codecs
+    , std::vector<list_group> const& groups
+    , driver_options const& options
+    , std::vector<bench_result>& results
+    , std::vector<scaling_result>& scaling_results)
+{
+    for (codec_factory const& factory : codecs) {
+        if (options.scaling) {
+            for (list_group const& group : groups) {
+                std::cerr << factory.name << " " << group.workload
+                    << " n=" << group.lists.front().size() << " (scaling)\n";
+                run_scaling(factory
+                    , group.workload
+                    , group.universe
+                    , group.lists
+                    , options.sweep
+                    , scaling_results);
+            }
+            continue;
+        }
+
+        // One codec per universe, reused across sizes like a real caller would
+        std::map<uint64_t, std::unique_ptr<bench_codec>> instances;
+        for (list_group const& group : groups) {
+            std::unique_ptr<bench_codec>& codec(instances[group.universe]);
+            if (!codec) {
+                codec = factory.make(group.universe);
+            }
+
+            std::cerr << factory.name << " " << group.workload
+                << " n=" << group.lists.front().size() << "\n";
+            run_benchmark(*codec
+                , factory.name
+                , group.workload
+                , group.universe
+                , group.lists
+                , options.bench
+                , results);
+        }
+    }
+}
+// ----------------------------------------------------------------------------
+static void run_generated(driver_options const& options
+    , std::vector<codec_factory> const& codecs
+    , std::vector<bench_result>& results
+    , std::vector<scaling_result>& scaling_results)
+{
+    workload_generator generator(options.seed);
+
+    std::vector<match_list_t> storage;
+    std::vector<list_group> groups;
+    for (workload_kind kind : options.workloads) {
+        for (uint32_t size : options.sizes) {
+            if (size > options.universe) {
+                continue;
+            }
+            for (uint32_t i(0); i < options.list_count; ++i) {
+                storage.push_back(generator.generate(kind, options.universe, size));
+            }
+            groups.push_back(list_group{ workload_name(kind), options.universe, {} });
+        }
+    }
+
+    // Spans only once `storage` stops moving
+    size_t next(0);
+    for (list_group& group : groups) {
+        for (uint32_t i(0); i < options.list_count; ++i) {
+            group.lists.push_back(storage[next++]);
+        }
+    }
+
+    run_groups(codecs, groups, options, results, scaling_results);
+}
+// ----------------------------------------------------------------------------
+static void run_corpus(driver_options const& options
+    , std::vector<codec_factory> const& codecs
+    , std::vector<bench_result>& results
+    , std::vector<scaling_result>& scaling_results)
+{
+    corpus_file corpus(options.corpus);
+
+    // Lists are read in place from the mapping
+    typedef std::tuple<workload_kind, uint64_t, size_t> group_key;
+    std::map<group_key, list_group> grouped;
+    for (size_t i(0); i < corpus.size(); ++i) {
+        group_key const key(corpus.kind(i), corpus.universe(i), corpus.matches(i).size());
+        list_group& group(grouped[key]);
+        group.workload = workload_name(corpus.kind(i));
+        group.universe = corpus.universe(i);
+        group.lists.push_back(corpus.matches(i));
+    }
+
+    std::vector<list_group> groups;
+    for (auto& entry : grouped) {
+        groups.push_back(entry.second);
+    }
+    run_groups(codecs, groups, options, results, scaling_results);
+}
+// ----------------------------------------------------------------------------
+static void train_models(driver_options const& options)
+{
+    corpus_file corpus(options.corpus);
+    gap_model_trainer trainer(options.universe);
+    for (size_t i(0); i < corpus.size(); ++i) {
+        if (corpus.universe(i) == options.universe) {
+            trainer.add(corpus.matches(i));
+        }
+    }
+    trainer.write(options.train_models, options.model_id);
+    std::cerr << "Trained gap models " << options.model_id
+        << " on " << trainer.size() << " lists of universe " << options.universe << "\n";
+}
+// ============================================================================
+int main(int argc, char* argv[])
+{
+    bool regressed(false);
+    try {
+        driver_options options(parse_arguments(argc, argv));
+        if (!options.train_models.empty()) {
+            train_models(options);
+            return 0;
+        }
+
+        std::vector<codec_factory> codecs(select_codecs(options.codecs));
+        if (!options.models.empty()) {
+            codecs.push_back(trained_gap_factory(std::make_shared<gap_models const>(options.models)));
+        }
+
+        // Without permission (or a PMU) the counter columns stay empty
+        std::unique_ptr<perf_counters> counters;
+        if (options.perf) {
+            counters.reset(new perf_counters());
+            if (counters->available()) {
+                options.bench.counters = counters.get();
+            } else {
+                std::cerr << "Hardware counters unavailable (" << counters->error() << ")\n";
+            }
+        }
+
+        std::vector<bench_result> results;
+        std::vector<scaling_result> scaling_results;
+        if (options.corpus.empty()) {
+            run_generated(options, codecs, results, scaling_results);
+        } else {
+            run_corpus(options, codecs, results, scaling_results);
+        }
+
+        std::vector<pareto_point> points;
+        if (options.pareto) {
+            points = pareto_points(results);
+            if (options.table.empty()) {
+                write_pareto_table(std::cerr, points);
+            } else {
+                std::ofstream file(options.table);
+                if (!file) {
+                    throw std::runtime_error("Unable to create " + options.table);
+                }
+                write_pareto_table(file, points);
+            }
+        }
+
+        auto write = [&](std::ostream& output) {
+            if (options.scaling) {
+                write_scaling_report(output, scaling_results, options.format);
+            } else if (options.pareto) {
+                write_pareto_report(output, points, options.format);
+            } else {
+                write_report(output, results, options.format);
+            }
+        };
+        if (options.output.empty()) {
+            write(std::cout);
+        } else {
+            std::ofstream file(options.output);
+            if (!file) {
+                throw std::runtime_error("Unable to create " + options.output);
+            }
+            write(file);
+        }
+
+        // Compared before saving, so both can name the same file
+        if (!options.baseline.empty()) {
+            std::string const cpu(cpu_model());
+            std::vector<regression_check> const checks(check_regressions(load_baseline(options.baseline)
+                , cpu
+                , results
+                , options.regression));
+            if (checks.empty()) {
+                throw std::runtime_error("No baseline results for " + cpu + " in " + options.baseline);
+            }
+            if (write_regressions(std::cerr, checks) != 0) {
+                regressed = true;
+            }
+        }
+        if (!options.save_baseline.empty()) {
+            save_baseline(options.save_baseline, cpu_model(), results);
+        }
+    } catch (std::exception const& e) {
+        std::cerr << "Error: " << e.what() << "\n" << USAGE;
+        return 1;
+    }
+    return regressed ? 2 : 0;
+}
+// ============================================================================
@@ -0,0 +1,217 @@
+#include <bench/bench_pareto.hpp>
+
+#include <bslc/estimators.hpp>
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <tuple>
+// ============================================================================
+// a no worse than b in all three, better in at least one
+static bool dominates(pareto_point const& a, pareto_point const& b)
+{
+    bool const no_worse((a.compressed_bytes <= b.compressed_bytes)
+        && (a.compress_mb_per_s >= b.compress_mb_per_s)
+        && (a.decompress_mb_per_s >= b.decompress_mb_per_s));
+    bool const better((a.compressed_bytes < b.compressed_bytes)
+        || (a.compress_mb_per_s > b.compress_mb_per_s)
+        || (a.decompress_mb_per_s > b.decompress_mb_per_s));
+    return no_worse && better;
+}
+// ============================================================================
+double pareto_point::density() const
+{
+    return (universe == 0) ? 0.0 : double(match_count) / double(universe);
+}
+// ----------------------------------------------------------------------------
+double pareto_point::size_ratio() const
+{
+    return (bound_bytes > 0.0) ? compressed_bytes / bound_bytes : -1.0;
+}
+// ----------------------------------------------------------------------------
+double pareto_point::bits_per_match() const
+{
+    return (match_count == 0) ? 0.0 : 8.0 * compressed_bytes / match_count;
+}
+// ============================================================================
+std::vector<pareto_point> pareto_points(std::vector<bench_result> const& results)
+{
+    typedef std::tuple<std::string, uint64_t, uint32_t, std::string> point_key;
+    std::map<point_key, pareto_point> points;
+    for (bench_result const& r : results) {
+        point_key const key(r.workload, r.universe, r.match_count, r.codec);
+        auto inserted(points.insert(std::make_pair(key, pareto_point())));
+        pareto_point& point(inserted.first->second);
+        if (inserted.second) {
+            point.codec = r.codec;
+            point.workload = r.workload;
+            point.universe = r.universe;
+            point.match_count = r.match_count;
+            point.compressed_bytes = r.compressed_bytes;
+            point.bound_bytes = subset_bits(r.universe, r.match_count) / 8.0;
+            point.compress_mb_per_s = 0.0;
+            point.decompress_mb_per_s = 0.0;
+            point.optimal = false;
+        }
+        if (r.operation == "compress") {
+            point.compress_mb_per_s = r.mb_per_s();
+        } else {
+            point.decompress_mb_per_s = r.mb_per_s();
+        }
+    }
+
+    // Keyed by density first, so the codecs of a group are adjacent
+    std::vector<pareto_point> output;
+    for (auto const& entry : points) {
+        output.push_back(entry.second);
+    }
+
+    size_t first(0);
+    while (first < output.size()) {
+        size_t last(first + 1);
+        while ((last < output.size())
+            && (output[last].workload == output[first].workload)
+            && (output[last].universe == output[first].universe)
+            && (output[last].match_count == output[first].match_count)) {
+            ++last;
+        }
+        for (size_t i(first); i < last; ++i) {
+            output[i].optimal = true;
+            for (size_t j(first); j < last; ++j) {
+                if (dominates(output[j], output[i])) {
+                    output[i].optimal = false;
+                    break;
+                }
+            }
+        }
+        first = last;
+    }
+    return output;
+}
+// ============================================================================
+static void write_ratio(std::ostream& output, double value, char const* missing)
+{
+    if (value < 0.0) {
+        output << missing;
+    } else {
+        output << value;
+    }
+}
+// ----------------------------------------------------------------------------
+static void write_csv(std::ostream& output, std::vector<pareto_point> const& points)
+{
+    output << "workload,universe,match_count,density,codec,compressed_bytes,bound_bytes"
+        << ",size_ratio,bits_per_match,compress_mb_per_s,decompress_mb_per_s,optimal\n";
+    for (pareto_point const& p : points) {
+        output << p.workload
+            << "," << p.universe
+            << "," << p.match_count
+            << "," << p.density()
+            << "," << p.codec
+            << "," << p.compressed_bytes
+            << "," << p.bound_bytes
+            << ",";
+        write_ratio(output, p.size_ratio(), "");
+        output << "," << p.bits_per_match()
+            << "," << p.compress_mb_per_s
+            << "," << p.decompress_mb_per_s
+            << "," << (p.optimal ? 1 : 0)
+            << "\n";
+    }
+}
+// ----------------------------------------------------------------------------
+static void write_json(std::ostream& output, std::vector<pareto_point> const& points)
+{
+    // Names are plain identifiers, nothing to escape
+    output << "{\n  \"pareto\": [";
+    for (size_t i(0); i < points.size(); ++i) {
+        pareto_point const& p(points[i]);
+        output << (i ? ",\n" : "\n")
+            << "    {\"workload\": \"" << p.workload << "\""
+            << ", \"universe\": " << p.universe
+            << ", \"match_count\": " << p.match_count
+            << ", \"density\": " << p.density()
+            << ", \"codec\": \"" << p.codec << "\""
+            << ", \"compressed_bytes\": " << p.compressed_bytes
+            << ", \"bound_bytes\": " << p.bound_bytes
+            << ", \"size_ratio\": ";
+        write_ratio(output, p.size_ratio(), "null");
+        output << ", \"bits_per_match\": " << p.bits_per_match()
+            << ", \"compress_mb_per_s\": " << p.compress_mb_per_s
+            << ", \"decompress_mb_per_s\": " << p.decompress_mb_per_s
+            << ", \"optimal\": " << (p.optimal ? "true" : "false")
+            << "}";
+    }
+    output << "\n  ]\n}\n";
+}
+// ----------------------------------------------------------------------------
+void write_pareto_report(std::ostream& output
+    , std::vector<pareto_point> const& points
+    , report_format format)
+{
+    std::streamsize const precision(output.precision(15));
+
+    switch (format) {
+    case report_format::csv: write_csv(output, points); break;
+    case report_format::json: write_json(output, points); break;
+    }
+
+    output.precision(precision);
+}
+// ----------------------------------------------------------------------------
+void write_pareto_table(std::ostream& output, std::vector<pareto_point> const& points)
+{
+    std::ios::fmtflags const flags(output.flags());
+    std::streamsize const precision(output.precision(2));
+    output << std::fixed;
+
+    size_t first(0);
+    while (first < points.size()) {
+        pareto_point const& group(points[first]);
+        std::vector<pareto_point> optimal;
+        size_t last(first);
+        for (; (last < points.size())
+            && (points[last].workload == group.workload)
+            && (points[last].universe == group.universe)
+            && (points[last].match_count == group.match_count); ++last) {
+            if (points[last].optimal) {
+                optimal.push_back(points[last]);
+            }
+        }
+        std::sort(optimal.begin(), optimal.end(), [](pareto_point const& a, pareto_point const& b) {
+            return a.compressed_bytes < b.compressed_bytes;
+        });
+
+        output << group.workload
+            << "  universe " << group.universe
+            << "  matches " << group.match_count
+            << "  density " << std::setprecision(6) << group.density()
+            << "  bound " << std::setprecision(1) << group.bound_bytes << " bytes\n"
+            << std::setprecision(2)
+            << "  " << std::left << std::setw(14) << "codec" << std::right
+            << std::setw(14) << "bytes"
+            << std::setw(10) << "x bound"
+            << std::setw(12) << "bits/match"
+            << std::setw(14) << "comp MB/s"
+            << std::setw(14) << "decomp MB/s" << "\n";
+        for (pareto_point const& p : optimal) {
+            output << "  " << std::left << std::setw(14) << p.codec << std::right
+                << std::setw(14) << p.compressed_bytes
+                << std::setw(10);
+            if (p.size_ratio() < 0.0) {
+                output << "-";
+            } else {
+                output << p.size_ratio();
+            }
+            output << std::setw(12) << p.bits_per_match()
+                << std::setw(14) << p.compress_mb_per_s
+                << std::setw(14) << p.decompress_mb_per_s << "\n";
+        }
+        output << "\n";
+        first = last;
+    }
+
+    output.precision(precision);
+    output.flags(flags);
+}
+// ============================================================================
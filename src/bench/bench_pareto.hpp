@@ -0,0 +1,45 @@
+#pragma once
+// ============================================================================
+#include <bench/bench_report.hpp>
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+// ============================================================================
+// Size and speed of one codec at one density, next to the entropy bound:
+// log2 C(universe, match_count) bits, what any codec needs on average for a
+// uniformly random subset of that size.
+struct pareto_point
+{
+    std::string codec;
+    std::string workload;
+    uint64_t universe;
+    uint32_t match_count;
+
+    double compressed_bytes;
+    double bound_bytes;
+    // Mean of the lists
+    double compress_mb_per_s;
+    double decompress_mb_per_s;
+    // No other codec at the same density is at least as small and at least
+    // as fast both ways, and strictly better in one of them
+    bool optimal;
+
+    double density() const;
+    // compressed / bound, < 0 when the bound is 0 (empty or full lists)
+    double size_ratio() const;
+    double bits_per_match() const;
+};
+// ----------------------------------------------------------------------------
+// Pairs the compress / decompress results of every codec x workload x
+// universe x list size and marks the Pareto optimal ones of each group
+std::vector<pareto_point> pareto_points(std::vector<bench_result> const& results);
+
+// Every point, one row each, for plotting
+void write_pareto_report(std::ostream& output
+    , std::vector<pareto_point> const& points
+    , report_format format);
+// The optimal set of each density as an aligned text table, smallest first
+void write_pareto_table(std::ostream& output, std::vector<pareto_point> const& points);
+// ============================================================================
@@ -0,0 +1,178 @@
+#include <bench/bench_report.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+// ============================================================================
+static double percentile(std::vector<uint64_t> const& sorted, double fraction)
+{
+    size_t rank(static_cast<size_t>(std::ceil(fraction * double(sorted.size()))));
+    rank = std::max(rank, size_t(1));
+    return double(sorted[std::min(rank, sorted.size()) - 1]);
+}
+// ----------------------------------------------------------------------------
+latency_summary summarize(std::vector<uint64_t> samples_ns)
+{
+    latency_summary summary = {};
+    if (samples_ns.empty()) {
+        return summary;
+    }
+
+    std::sort(samples_ns.begin(), samples_ns.end());
+
+    summary.count = samples_ns.size();
+    summary.mean_ns = std::accumulate(samples_ns.begin(), samples_ns.end(), 0.0) / double(summary.count);
+    summary.min_ns = double(samples_ns.front());
+    summary.p50_ns = percentile(samples_ns, 0.5);
+    summary.p99_ns = percentile(samples_ns, 0.99);
+    summary.p999_ns = percentile(samples_ns, 0.999);
+    summary.max_ns = double(samples_ns.back());
+    return summary;
+}
+// ============================================================================
+double bench_result::ns_per_element() const
+{
+    return (match_count == 0) ? 0.0 : latency.mean_ns / match_count;
+}
+// ----------------------------------------------------------------------------
+double bench_result::mb_per_s() const
+{
+    if (latency.mean_ns <= 0.0) {
+        return 0.0;
+    }
+    // bytes per ns = 1000 MB/s
+    return double(match_count) * sizeof(uint32_t) / latency.mean_ns * 1000.0;
+}
+// ----------------------------------------------------------------------------
+double bench_result::perf_per_element(perf_counter counter) const
+{
+    if ((perf_calls == 0) || !perf.has(counter)) {
+        return -1.0;
+    }
+    return perf.get(counter) / (double(perf_calls) * std::max(match_count, 1U));
+}
+// ----------------------------------------------------------------------------
+double bench_result::ipc() const
+{
+    if ((perf_calls == 0)
+        || !perf.has(perf_counter::cycles)
+        || !perf.has(perf_counter::instructions)
+        || (perf.get(perf_counter::cycles) <= 0.0)) {
+        return -1.0;
+    }
+    return perf.get(perf_counter::instructions) / perf.get(perf_counter::cycles);
+}
+// ============================================================================
+// Counter columns, empty (CSV) or null (JSON) when not measured
+static perf_counter const REPORTED_COUNTERS[] = {
+    perf_counter::cycles,
+    perf_counter::branch_misses,
+    perf_counter::l1d_misses,
+    perf_counter::llc_misses,
+};
+// ----------------------------------------------------------------------------
+static void write_measurement(std::ostream& output, double value, char const* missing)
+{
+    if (value < 0.0) {
+        output << missing;
+    } else {
+        output << value;
+    }
+}
+// ============================================================================
+report_format parse_report_format(std::string const& name)
+{
+    if (name == "csv") {
+        return report_format::csv;
+    }
+    if (name == "json") {
+        return report_format::json;
+    }
+    throw std::runtime_error("Unknown report format: " + name);
+}
+// ----------------------------------------------------------------------------
+static void write_csv(std::ostream& output, std::vector<bench_result> const& results)
+{
+    output << "codec,workload,universe,match_count,operation,compressed_bytes"
+        << ",iterations,mean_ns,min_ns,p50_ns,p99_ns,p999_ns,max_ns"
+        << ",ns_per_element,mb_per_s,ipc";
+    for (perf_counter counter : REPORTED_COUNTERS) {
+        output << "," << perf_counter_name(counter) << "_per_element";
+    }
+    output << "\n";
+
+    for (bench_result const& r : results) {
+        output << r.codec
+            << "," << r.workload
+            << "," << r.universe
+            << "," << r.match_count
+            << "," << r.operation
+            << "," << r.compressed_bytes
+            << "," << r.latency.count
+            << "," << r.latency.mean_ns
+            << "," << r.latency.min_ns
+            << "," << r.latency.p50_ns
+            << "," << r.latency.p99_ns
+            << "," << r.latency.p999_ns
+            << "," << r.latency.max_ns
+            << "," << r.ns_per_element()
+            << "," << r.mb_per_s()
+            << ",";
+        write_measurement(output, r.ipc(), "");
+        for (perf_counter counter : REPORTED_COUNTERS) {
+            output << ",";
+            write_measurement(output, r.perf_per_element(counter), "");
+        }
+        output << "\n";
+    }
+}
+// ----------------------------------------------------------------------------
+static void write_json(std::ostream& output, std::vector<bench_result> const& results)
+{
+    // Names are plain identifiers, nothing to escape
+    output << "{\n  \"results\": [";
+    for (size_t i(0); i < results.size(); ++i) {
+        bench_result const& r(results[i]);
+        output << (i ? ",\n" : "\n")
+            << "    {\"codec\": \"" << r.codec << "\""
+            << ", \"workload\": \"" << r.workload << "\""
+            << ", \"universe\": " << r.universe
+            << ", \"match_count\": " << r.match_count
+            << ", \"operation\": \"" << r.operation << "\""
+            << ", \"compressed_bytes\": " << r.compressed_bytes
+            << ", \"iterations\": " << r.latency.count
+            << ", \"mean_ns\": " << r.latency.mean_ns
+            << ", \"min_ns\": " << r.latency.min_ns
+            << ", \"p50_ns\": " << r.latency.p50_ns
+            << ", \"p99_ns\": " << r.latency.p99_ns
+            << ", \"p999_ns\": " << r.latency.p999_ns
+            << ", \"max_ns\": " << r.latency.max_ns
+            << ", \"ns_per_element\": " << r.ns_per_element()
+            << ", \"mb_per_s\": " << r.mb_per_s()
+            << ", \"ipc\": ";
+        write_measurement(output, r.ipc(), "null");
+        for (perf_counter counter : REPORTED_COUNTERS) {
+            output << ", \"" << perf_counter_name(counter) << "_per_element\": ";
+            write_measurement(output, r.perf_per_element(counter), "null");
+        }
+        output << "}";
+    }
+    output << "\n  ]\n}\n";
+}
+// ----------------------------------------------------------------------------
+void write_report(std::ostream& output
+    , std::vector<bench_result> const& results
+    , report_format format)
+{
+    // Plain digits for the nanosecond counts
+    std::streamsize const precision(output.precision(15));
+
+    switch (format) {
+    case report_format::csv: write_csv(output, results); break;
+    case report_format::json: write_json(output, results); break;
+    }
+
+    output.precision(precision);
+}
+// ============================================================================
@@ -0,0 +1,67 @@
+#pragma once
+// ============================================================================
+#include <bench/perf_counters.hpp>
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+// ============================================================================
+struct latency_summary
+{
+    uint64_t count;
+    double mean_ns;
+    double min_ns;
+    double p50_ns;
+    double p99_ns;
+    double p999_ns;
+    double max_ns;
+};
+
+// Nearest rank percentiles, all zero for no samples
+latency_summary summarize(std::vector<uint64_t> samples_ns);
+// ----------------------------------------------------------------------------
+// One codec x workload x list size x operation
+struct bench_result
+{
+    std::string codec;
+    std::string workload;
+    uint64_t universe;
+    uint32_t match_count;
+    std::string operation; // "compress" or "decompress"
+
+    // Mean over the lists of the run
+    double compressed_bytes;
+
+    latency_summary latency;
+    // Per call wall time, in call order
+    std::vector<uint64_t> samples_ns;
+
+    // Hardware counter totals of the separate profiling pass, if any
+    perf_values perf;
+    uint32_t perf_calls;
+
+    // Based on the mean latency. Throughput counts the uncompressed list
+    // (4 bytes per match) in both directions
+    double ns_per_element() const;
+    double mb_per_s() const;
+
+    // Counter per element (per call for empty lists), < 0 if not measured
+    double perf_per_element(perf_counter counter) const;
+    // Instructions per cycle, < 0 if not measured
+    double ipc() const;
+};
+// ============================================================================
+enum class report_format
+{
+    csv,
+    json,
+};
+
+// Throws on anything but "csv" / "json"
+report_format parse_report_format(std::string const& name);
+
+void write_report(std::ostream& output
+    , std::vector<bench_result> const& results
+    , report_format format);
+// ============================================================================
@@ -0,0 +1,114 @@
+#include <bench/bench_runner.hpp>
+
+#include <bslc/match_list.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+// ============================================================================
+// Keeps the optimizer from dropping calls whose results are never looked at
+static volatile size_t benchmark_sink(0);
+// ============================================================================
+uint64_t bench_now_ns()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+// ----------------------------------------------------------------------------
+// Runs call(0 ... warmup + iterations - 1), keeps the times after the warmup
+template <typename Call>
+static void time_calls(Call const& call, bench_options const& options, std::vector<uint64_t>& samples_ns)
+{
+    samples_ns.clear();
+    samples_ns.reserve(options.iterations);
+    for (uint32_t i(0); i < options.warmup + options.iterations; ++i) {
+        uint64_t const start(bench_now_ns());
+        call(i);
+        uint64_t const stop(bench_now_ns());
+        if (i >= options.warmup) {
+            samples_ns.push_back(stop - start);
+        }
+    }
+}
+// ----------------------------------------------------------------------------
+// Sums the counters of `iterations` calls, returns the number of calls
+template <typename Call>
+static uint32_t profile_calls(Call const& call, bench_options const& options, perf_values& totals)
+{
+    totals.clear();
+    perf_values values;
+    for (uint32_t i(0); i < options.iterations; ++i) {
+        options.counters->start();
+        call(i);
+        options.counters->stop(values);
+        totals.add(values);
+    }
+    return options.iterations;
+}
+// ============================================================================
+void run_benchmark(bench_codec& codec
+    , std::string const& codec_name
+    , std::string const& workload
+    , uint64_t universe
+    , std::vector<span<uint32_t const>> const& lists
+    , bench_options const& options
+    , std::vector<bench_result>& results)
+{
+    if (lists.empty()) {
+        return;
+    }
+    uint32_t const match_count(static_cast<uint32_t>(lists.front().size()));
+
+    // Compress every list once up front, the decompression input
+    std::vector<buffer_t> compressed(lists.size());
+    match_list_t decompressed(match_count);
+    double total_bytes(0.0);
+    for (size_t i(0); i < lists.size(); ++i) {
+        compressed[i].resize(codec.max_compressed_size(match_count));
+        compressed[i].resize(codec.compress_into(lists[i], compressed[i]));
+        total_bytes += double(compressed[i].size());
+
+        size_t const count(codec.decompress_into(compressed[i], decompressed));
+        if ((count != lists[i].size())
+            || !std::equal(lists[i].begin(), lists[i].end(), decompressed.begin())) {
+            throw std::runtime_error("Codec error: " + codec_name);
+        }
+    }
+
+    bench_result result;
+    result.codec = codec_name;
+    result.workload = workload;
+    result.universe = universe;
+    result.match_count = match_count;
+    result.compressed_bytes = total_bytes / double(lists.size());
+    result.perf.clear();
+    result.perf_calls = 0;
+
+    buffer_t output(codec.max_compressed_size(match_count));
+    size_t sink(0);
+
+    result.operation = "compress";
+    auto compress_call = [&](uint32_t i) {
+        sink += codec.compress_into(lists[i % lists.size()], output);
+    };
+    time_calls(compress_call, options, result.samples_ns);
+    result.latency = summarize(result.samples_ns);
+    if (options.counters) {
+        result.perf_calls = profile_calls(compress_call, options, result.perf);
+    }
+    results.push_back(result);
+
+    result.operation = "decompress";
+    auto decompress_call = [&](uint32_t i) {
+        sink += codec.decompress_into(compressed[i % compressed.size()], decompressed);
+    };
+    time_calls(decompress_call, options, result.samples_ns);
+    result.latency = summarize(result.samples_ns);
+    if (options.counters) {
+        result.perf_calls = profile_calls(decompress_call, options, result.perf);
+    }
+    results.push_back(result);
+
+    benchmark_sink = benchmark_sink + sink;
+}
+// ============================================================================
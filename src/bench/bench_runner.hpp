@@ -0,0 +1,40 @@
+#pragma once
+// ============================================================================
+#include <bench/bench_codecs.hpp>
+#include <bench/bench_report.hpp>
+#include <bench/perf_counters.hpp>
+
+#include <bslc/span.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+// ============================================================================
+struct bench_options
+{
+    // Untimed calls before the measured ones, to warm caches, branch
+    // predictors and the codec's own buffers
+    uint32_t warmup = 8;
+    // Timed calls per operation
+    uint32_t iterations = 64;
+    // When set, another `iterations` calls per operation run with hardware
+    // counters around every call. Kept apart from the timed calls, the
+    // counter syscalls would skew the latencies
+    perf_counters* counters = nullptr;
+};
+// ----------------------------------------------------------------------------
+// Times single compress_into / decompress_into calls over `lists` (all of the
+// same size, used round robin) and appends one result per operation.
+//
+// Every list is round tripped and checked first, throws on a mismatch.
+void run_benchmark(bench_codec& codec
+    , std::string const& codec_name
+    , std::string const& workload
+    , uint64_t universe
+    , std::vector<span<uint32_t const>> const& lists
+    , bench_options const& options
+    , std::vector<bench_result>& results);
+// ----------------------------------------------------------------------------
+// Monotonic clock in nanoseconds
+uint64_t bench_now_ns();
+// ============================================================================
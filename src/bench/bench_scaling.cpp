@@ -0,0 +1,289 @@
+#include <bench/bench_scaling.hpp>
+#include <bench/bench_runner.hpp>
+
+#include <bslc/match_list.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+// ============================================================================
+// Keeps the optimizer from dropping calls whose results are never looked at
+static std::atomic<size_t> scaling_sink(0);
+// ============================================================================
+std::vector<uint32_t> default_thread_counts()
+{
+    uint32_t const hardware(std::max(std::thread::hardware_concurrency(), 1U));
+    std::vector<uint32_t> counts;
+    for (uint32_t count(1); count < hardware; count *= 2) {
+        counts.push_back(count);
+    }
+    counts.push_back(hardware);
+    return counts;
+}
+// ----------------------------------------------------------------------------
+std::vector<uint64_t> default_working_sets()
+{
+    return { uint64_t(16) << 10, uint64_t(256) << 10, uint64_t(4) << 20, uint64_t(64) << 20 };
+}
+// ============================================================================
+double scaling_result::mb_per_s() const
+{
+    if (wall_ns == 0) {
+        return 0.0;
+    }
+    // bytes per ns = 1000 MB/s
+    return double(calls) * match_count * sizeof(uint32_t) / double(wall_ns) * 1000.0;
+}
+// ----------------------------------------------------------------------------
+double scaling_result::mb_per_s_per_thread() const
+{
+    return mb_per_s() / threads;
+}
+// ============================================================================
+// Lists [first, last) of the working set, worked on by one thread
+struct scaling_slice
+{
+    size_t first;
+    size_t last;
+    uint64_t start_ns;
+    uint64_t stop_ns;
+};
+// ----------------------------------------------------------------------------
+// Runs call(thread, list) -> size_t on `slices.size()` threads: one untimed
+// call to set up the codec, then `iterations` timed calls each, spread
+// evenly over the thread's lists (round robin when there are fewer lists
+// than calls). In a large working set, consecutive calls touch lists far
+// apart, so the lists are not in cache. All threads are started and warmed
+// up before any of them starts the clock.
+//
+// Returns the wall time from the first start to the last stop.
+template <typename Call>
+static uint64_t run_threads(std::vector<scaling_slice>& slices, uint32_t iterations, Call const& call)
+{
+    uint32_t const thread_count(static_cast<uint32_t>(slices.size()));
+    std::atomic<uint32_t> ready(0);
+    std::atomic<bool> go(false);
+
+    auto work = [&](uint32_t t) {
+        scaling_slice& slice(slices[t]);
+        size_t const list_count(slice.last - slice.first);
+        size_t const step(std::max<size_t>(list_count / iterations, 1));
+        // Summed locally, a shared counter would be contended itself
+        size_t sink(call(t, slice.last - 1));
+
+        ++ready;
+        while (!go.load()) {
+            std::this_thread::yield();
+        }
+
+        slice.start_ns = bench_now_ns();
+        for (size_t i(0); i < iterations; ++i) {
+            sink += call(t, slice.first + (i * step) % list_count);
+        }
+        slice.stop_ns = bench_now_ns();
+        scaling_sink += sink;
+    };
+
+    std::vector<std::thread> threads;
+    for (uint32_t t(0); t < thread_count; ++t) {
+        threads.emplace_back(work, t);
+    }
+    while (ready.load() < thread_count) {
+        std::this_thread::yield();
+    }
+    go.store(true);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    uint64_t start(UINT64_MAX);
+    uint64_t stop(0);
+    for (scaling_slice const& slice : slices) {
+        start = std::min(start, slice.start_ns);
+        stop = std::max(stop, slice.stop_ns);
+    }
+    return stop - start;
+}
+// ----------------------------------------------------------------------------
+// Per thread share of the working set, at least one list each
+static std::vector<scaling_slice> split_lists(size_t list_count, uint32_t thread_count)
+{
+    std::vector<scaling_slice> slices(thread_count);
+    for (uint32_t t(0); t < thread_count; ++t) {
+        slices[t].first = list_count * t / thread_count;
+        slices[t].last = std::max(list_count * (t + 1) / thread_count, slices[t].first + 1);
+        slices[t].start_ns = slices[t].stop_ns = 0;
+    }
+    return slices;
+}
+// ============================================================================
+void run_scaling(codec_factory const& factory
+    , std::string const& workload
+    , uint64_t universe
+    , std::vector<span<uint32_t const>> const& lists
+    , scaling_options const& options
+    , std::vector<scaling_result>& results)
+{
+    if (lists.empty() || lists.front().empty() || options.thread_counts.empty()) {
+        return;
+    }
+    uint32_t const match_count(static_cast<uint32_t>(lists.front().size()));
+    uint32_t const max_threads(*std::max_element(options.thread_counts.begin(), options.thread_counts.end()));
+    std::unique_ptr<bench_codec> const reference(factory.make(universe));
+    size_t const bound(reference->max_compressed_size(match_count));
+
+    // Every distinct list is compressed once, and checked, through one
+    // scratch buffer. Bitmap codecs take O(universe) per call, too slow to
+    // repeat for every copy of a large working set
+    std::vector<buffer_t> pool(lists.size());
+    {
+        buffer_t scratch(bound);
+        match_list_t decompressed(match_count);
+        for (size_t i(0); i < lists.size(); ++i) {
+            span<uint32_t const> const list(lists[i]);
+            size_t const size(reference->compress_into(list, scratch));
+            pool[i].assign(scratch.begin(), scratch.begin() + size);
+
+            size_t const count(reference->decompress_into(pool[i], decompressed));
+            if ((count != list.size()) || !std::equal(list.begin(), list.end(), decompressed.begin())) {
+                throw std::runtime_error("Codec error: " + factory.name);
+            }
+        }
+    }
+
+    for (uint64_t working_set : options.working_sets) {
+        // Copies packed back to back, so every list of the working set has
+        // memory of its own and nothing else: list i at inputs[i * match_count],
+        // its compressed form at compressed[offsets[i], offsets[i + 1])
+        size_t const list_count(std::max<size_t>(max_threads
+            , static_cast<size_t>((working_set + match_count * sizeof(uint32_t) - 1)
+                / (match_count * sizeof(uint32_t)))));
+        match_list_t inputs(list_count * match_count);
+        std::vector<size_t> offsets(list_count + 1, 0);
+        for (size_t i(0); i < list_count; ++i) {
+            span<uint32_t const> const list(lists[i % lists.size()]);
+            std::copy(list.begin(), list.end(), inputs.begin() + i * match_count);
+            offsets[i + 1] = offsets[i] + pool[i % lists.size()].size();
+        }
+        buffer_t compressed(offsets[list_count]);
+        for (size_t i(0); i < list_count; ++i) {
+            buffer_t const& source(pool[i % lists.size()]);
+            std::copy(source.begin(), source.end(), compressed.begin() + offsets[i]);
+        }
+
+        size_t const first_result(results.size());
+        for (uint32_t thread_count : options.thread_counts) {
+            if (thread_count == 0) {
+                continue;
+            }
+
+            // Codecs and output buffers per thread
+            std::vector<std::unique_ptr<bench_codec>> codecs;
+            std::vector<buffer_t> outputs(thread_count, buffer_t(bound));
+            std::vector<match_list_t> matches(thread_count, match_list_t(match_count));
+            for (uint32_t t(0); t < thread_count; ++t) {
+                codecs.push_back(factory.make(universe));
+            }
+
+            scaling_result result;
+            result.codec = factory.name;
+            result.workload = workload;
+            result.universe = universe;
+            result.match_count = match_count;
+            result.working_set = working_set;
+            result.threads = thread_count;
+            result.efficiency = 1.0;
+
+            std::vector<scaling_slice> slices(split_lists(list_count, thread_count));
+            result.operation = "compress";
+            result.wall_ns = run_threads(slices, options.iterations, [&](uint32_t t, size_t i) {
+                span<uint32_t const> const input(inputs.data() + i * match_count, match_count);
+                return codecs[t]->compress_into(input, outputs[t]);
+            });
+            result.calls = uint64_t(options.iterations) * thread_count;
+            results.push_back(result);
+
+            result.operation = "decompress";
+            result.wall_ns = run_threads(slices, options.iterations, [&](uint32_t t, size_t i) {
+                span<uint8_t const> const input(compressed.data() + offsets[i], offsets[i + 1] - offsets[i]);
+                return codecs[t]->decompress_into(input, matches[t]);
+            });
+            results.push_back(result);
+        }
+
+        // Relative to the fewest threads of this working set, per operation
+        for (size_t i(first_result); i < results.size(); ++i) {
+            scaling_result const* base(nullptr);
+            for (size_t j(first_result); j < results.size(); ++j) {
+                if ((results[j].operation == results[i].operation)
+                    && (!base || (results[j].threads < base->threads))) {
+                    base = &results[j];
+                }
+            }
+            double const base_rate(base->mb_per_s_per_thread());
+            results[i].efficiency = (base_rate > 0.0) ? results[i].mb_per_s_per_thread() / base_rate : 0.0;
+        }
+    }
+}
+// ============================================================================
+static void write_csv(std::ostream& output, std::vector<scaling_result> const& results)
+{
+    output << "codec,workload,universe,match_count,working_set,threads,operation"
+        << ",calls,wall_ns,mb_per_s,mb_per_s_per_thread,efficiency\n";
+    for (scaling_result const& r : results) {
+        output << r.codec
+            << "," << r.workload
+            << "," << r.universe
+            << "," << r.match_count
+            << "," << r.working_set
+            << "," << r.threads
+            << "," << r.operation
+            << "," << r.calls
+            << "," << r.wall_ns
+            << "," << r.mb_per_s()
+            << "," << r.mb_per_s_per_thread()
+            << "," << r.efficiency
+            << "\n";
+    }
+}
+// ----------------------------------------------------------------------------
+static void write_json(std::ostream& output, std::vector<scaling_result> const& results)
+{
+    // Names are plain identifiers, nothing to escape
+    output << "{\n  \"scaling\": [";
+    for (size_t i(0); i < results.size(); ++i) {
+        scaling_result const& r(results[i]);
+        output << (i ? ",\n" : "\n")
+            << "    {\"codec\": \"" << r.codec << "\""
+            << ", \"workload\": \"" << r.workload << "\""
+            << ", \"universe\": " << r.universe
+            << ", \"match_count\": " << r.match_count
+            << ", \"working_set\": " << r.working_set
+            << ", \"threads\": " << r.threads
+            << ", \"operation\": \"" << r.operation << "\""
+            << ", \"calls\": " << r.calls
+            << ", \"wall_ns\": " << r.wall_ns
+            << ", \"mb_per_s\": " << r.mb_per_s()
+            << ", \"mb_per_s_per_thread\": " << r.mb_per_s_per_thread()
+            << ", \"efficiency\": " << r.efficiency
+            << "}";
+    }
+    output << "\n  ]\n}\n";
+}
+// ----------------------------------------------------------------------------
+void write_scaling_report(std::ostream& output
+    , std::vector<scaling_result> const& results
+    , report_format format)
+{
+    std::streamsize const precision(output.precision(15));
+
+    switch (format) {
+    case report_format::csv: write_csv(output, results); break;
+    case report_format::json: write_json(output, results); break;
+    }
+
+    output.precision(precision);
+}
+// ============================================================================
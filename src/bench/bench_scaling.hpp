@@ -0,0 +1,70 @@
+#pragma once
+// ============================================================================
+#include <bench/bench_codecs.hpp>
+#include <bench/bench_report.hpp>
+
+#include <bslc/span.hpp>
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+// ============================================================================
+struct scaling_options
+{
+    // Concurrent threads, each with its own codec instance
+    std::vector<uint32_t> thread_counts;
+    // Uncompressed bytes of all lists of a run together, split evenly
+    // between the threads: from cache resident to DRAM bound
+    std::vector<uint64_t> working_sets;
+    // Timed calls per thread, spread over the thread's lists
+    uint32_t iterations = 64;
+};
+
+// Thread counts 1, 2, 4, ... up to and including the hardware threads
+std::vector<uint32_t> default_thread_counts();
+// 16 KiB, 256 KiB, 4 MiB, 64 MiB
+std::vector<uint64_t> default_working_sets();
+// ----------------------------------------------------------------------------
+// One codec x workload x list size x working set x thread count x operation
+struct scaling_result
+{
+    std::string codec;
+    std::string workload;
+    uint64_t universe;
+    uint32_t match_count;
+    uint64_t working_set;
+    uint32_t threads;
+    std::string operation; // "compress" or "decompress"
+
+    // Calls of all threads together, and the wall time from the first
+    // thread starting to the last one finishing
+    uint64_t calls;
+    uint64_t wall_ns;
+
+    // Aggregate, uncompressed bytes in both directions
+    double mb_per_s() const;
+    double mb_per_s_per_thread() const;
+    // Throughput per thread relative to the fewest threads of the same
+    // sweep, 1 = perfect scaling. Filled in by run_scaling
+    double efficiency;
+};
+// ----------------------------------------------------------------------------
+// Sweeps `options.thread_counts` x `options.working_sets` for one list size.
+// `lists` is the pool of distinct lists (all of the same size) a working
+// set is filled from, reused round robin when it needs more lists than
+// there are.
+//
+// Every thread works on lists and buffers of its own, so what doesn't scale
+// is the memory system or state shared inside the codecs and the allocator.
+void run_scaling(codec_factory const& factory
+    , std::string const& workload
+    , uint64_t universe
+    , std::vector<span<uint32_t const>> const& lists
+    , scaling_options const& options
+    , std::vector<scaling_result>& results);
+
+void write_scaling_report(std::ostream& output
+    , std::vector<scaling_result> const& results
+    , report_format format);
+// ============================================================================
@@ -0,0 +1,410 @@
+#include <fastac/adaptive_bit_model.hpp>
+#include <fastac/adaptive_data_model.hpp>
+#include <fastac/arithmetic_codec.hpp>
+#include <fastac/static_bit_model.hpp>
+#include <fastac/static_data_model.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+// ============================================================================
+// Symbols per second of every arithmetic_codec coding primitive, one row per
+// primitive x model x alphabet x skew x direction.
+//
+// The data models switch to table decoding above 16 symbols, the alphabets
+// straddle that. propagate_carry is private: the put_bits "ones" streams
+// carry on most symbols and ripple through runs of 0xFF bytes, the "zeros"
+// streams never carry, the difference is its cost.
+// ============================================================================
+static char const* const USAGE =
+    "Usage: fastac_bench [options]\n"
+    "  --symbols n     symbols per stream (default: 1048576)\n"
+    "  --repeats n     passes per direction, the fastest is kept (default: 5)\n"
+    "  --seed n        symbol seed (default: 1)\n"
+    "  --output path   CSV report file (default: stdout)\n";
+
+// The codec refuses larger buffers
+static uint32_t const MAX_CODE_BYTES(0x1000000);
+// static_data_model rejects probabilities below 0.0001
+static double const MIN_PROBABILITY(0.00011);
+// ----------------------------------------------------------------------------
+struct micro_options
+{
+    uint32_t symbol_count = 1 << 20;
+    uint32_t repeats = 5;
+    uint64_t seed = 1;
+    std::string output;
+};
+// ----------------------------------------------------------------------------
+struct micro_result
+{
+    std::string primitive;
+    std::string model;
+    uint32_t alphabet;
+    std::string skew;
+    bool decoder_table;
+    std::string direction;
+    uint32_t symbol_count;
+    double ns;
+    uint32_t code_bytes;
+};
+// ----------------------------------------------------------------------------
+// One stream and the model(s) it is coded with
+struct micro_case
+{
+    std::string primitive;
+    std::string model;
+    uint32_t alphabet;
+    std::string skew;
+    std::vector<uint32_t> symbols;
+    // Symbol probabilities, for the static models
+    std::vector<double> probability;
+};
+// ============================================================================
+// splitmix64, so streams are identical everywhere
+class micro_random
+{
+public:
+    explicit micro_random(uint64_t seed)
+        : state(seed)
+    {
+    }
+
+    uint64_t next()
+    {
+        uint64_t z(state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform in [0, 1)
+    double next_double()
+    {
+        return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+private:
+    uint64_t state;
+};
+// ============================================================================
+static uint64_t now_ns()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+// ----------------------------------------------------------------------------
+static uint64_t parse_number(std::string const& text)
+{
+    size_t used(0);
+    unsigned long long value(std::stoull(text, &used));
+    if (used != text.size()) {
+        throw std::runtime_error("Invalid number: " + text);
+    }
+    return value;
+}
+// ----------------------------------------------------------------------------
+static micro_options parse_arguments(int argc, char* argv[])
+{
+    micro_options options;
+    for (int i(1); i < argc; ++i) {
+        std::string const name(argv[i]);
+        if ((name == "--help") || (name == "-h")) {
+            std::cout << USAGE;
+            std::exit(0);
+        }
+        if (i + 1 >= argc) {
+            throw std::runtime_error("Missing value for " + name);
+        }
+        std::string const value(argv[++i]);
+
+        if (name == "--symbols") {
+            options.symbol_count = static_cast<uint32_t>(parse_number(value));
+        } else if (name == "--repeats") {
+            options.repeats = static_cast<uint32_t>(parse_number(value));
+        } else if (name == "--seed") {
+            options.seed = parse_number(value);
+        } else if (name == "--output") {
+            options.output = value;
+        } else {
+            throw std::runtime_error("Unknown option: " + name);
+        }
+    }
+
+    // put_bits(20) streams take up to 20 bits per symbol
+    if ((options.symbol_count == 0) || (options.symbol_count > MAX_CODE_BYTES / 3)) {
+        throw std::runtime_error("Symbol count out of range.");
+    }
+    if (options.repeats == 0) {
+        throw std::runtime_error("Need at least one repeat.");
+    }
+    return options;
+}
+// ============================================================================
+// Alphabet distributions, each floored so static_data_model accepts it:
+//   uniform    all equal
+//   zipf       p(k) ~ 1 / (k + 1)
+//   geometric  p(k) ~ 0.75^k, nearly all mass on the first dozen symbols
+static std::vector<double> make_distribution(std::string const& skew, uint32_t alphabet)
+{
+    std::vector<double> weights(alphabet);
+    for (uint32_t k(0); k < alphabet; ++k) {
+        if (skew == "zipf") {
+            weights[k] = 1.0 / double(k + 1);
+        } else if (skew == "geometric") {
+            weights[k] = std::pow(0.75, double(k));
+        } else {
+            weights[k] = 1.0;
+        }
+    }
+
+    double total(0.0);
+    for (double w : weights) {
+        total += w;
+    }
+    double const spread(1.0 - MIN_PROBABILITY * alphabet);
+    for (double& w : weights) {
+        w = MIN_PROBABILITY + spread * w / total;
+    }
+    return weights;
+}
+// ----------------------------------------------------------------------------
+static std::vector<uint32_t> draw_symbols(std::vector<double> const& probability
+    , uint32_t count
+    , micro_random& random)
+{
+    std::vector<double> cumulative(probability.size());
+    double sum(0.0);
+    for (size_t k(0); k < probability.size(); ++k) {
+        sum += probability[k];
+        cumulative[k] = sum;
+    }
+
+    std::vector<uint32_t> symbols(count);
+    for (uint32_t& symbol : symbols) {
+        double const u(random.next_double() * sum);
+        size_t const k(std::upper_bound(cumulative.begin(), cumulative.end(), u) - cumulative.begin());
+        symbol = static_cast<uint32_t>(std::min(k, probability.size() - 1));
+    }
+    return symbols;
+}
+// ----------------------------------------------------------------------------
+static std::vector<micro_case> make_cases(micro_options const& options)
+{
+    micro_random random(options.seed);
+    std::vector<micro_case> cases;
+
+    // Raw bits: put_bit, then put_bits at several widths with random data
+    // and with the carry extremes
+    {
+        micro_case c{ "put_bit", "none", 2, "uniform", {}, {} };
+        c.symbols = draw_symbols(make_distribution("uniform", 2), options.symbol_count, random);
+        cases.push_back(c);
+    }
+    for (uint32_t bits : { 1U, 8U, 16U, 20U }) {
+        uint32_t const alphabet(1U << bits);
+        micro_case c{ "put_bits", "none", alphabet, "uniform", {}, {} };
+        c.symbols.resize(options.symbol_count);
+        for (uint32_t& symbol : c.symbols) {
+            symbol = static_cast<uint32_t>(random.next()) & (alphabet - 1);
+        }
+        cases.push_back(c);
+
+        c.skew = "zeros";
+        std::fill(c.symbols.begin(), c.symbols.end(), 0);
+        cases.push_back(c);
+
+        c.skew = "ones";
+        std::fill(c.symbols.begin(), c.symbols.end(), alphabet - 1);
+        cases.push_back(c);
+    }
+
+    // Bit models: P(0) from fair to nearly certain
+    for (double p0 : { 0.5, 0.9, 0.99, 0.999 }) {
+        std::vector<double> const probability{ p0, 1.0 - p0 };
+        std::string const skew("p0=" + std::to_string(p0).substr(0, 5));
+        for (char const* model : { "static_bit_model", "adaptive_bit_model" }) {
+            micro_case c{ "encode", model, 2, skew, {}, probability };
+            c.symbols = draw_symbols(probability, options.symbol_count, random);
+            cases.push_back(c);
+        }
+    }
+
+    // Data models, both sides of the decoder table threshold
+    for (uint32_t alphabet : { 2U, 4U, 16U, 17U, 64U, 256U, 2048U }) {
+        for (char const* skew : { "uniform", "zipf", "geometric" }) {
+            std::vector<double> const probability(make_distribution(skew, alphabet));
+            std::vector<uint32_t> const symbols(draw_symbols(probability, options.symbol_count, random));
+            for (char const* model : { "static_data_model", "adaptive_data_model" }) {
+                cases.push_back(micro_case{ "encode", model, alphabet, skew, symbols, probability });
+            }
+        }
+    }
+    return cases;
+}
+// ============================================================================
+// Times `options.repeats` passes of each direction, keeps the fastest and
+// checks the decoded symbols. `reset` puts the model(s) back in the state
+// the encoder started from.
+template <typename Reset, typename Encode, typename Decode>
+static void run_case(micro_case const& c
+    , micro_options const& options
+    , Reset const& reset
+    , Encode const& encode
+    , Decode const& decode
+    , std::vector<micro_result>& results)
+{
+    arithmetic_codec codec(MAX_CODE_BYTES);
+    std::vector<uint32_t> decoded(c.symbols.size());
+
+    uint64_t best_encode(UINT64_MAX);
+    uint64_t best_decode(UINT64_MAX);
+    uint32_t code_bytes(0);
+    for (uint32_t r(0); r < options.repeats; ++r) {
+        reset();
+        uint64_t start(now_ns());
+        codec.start_encoder();
+        for (uint32_t symbol : c.symbols) {
+            encode(codec, symbol);
+        }
+        code_bytes = codec.stop_encoder();
+        best_encode = std::min(best_encode, now_ns() - start);
+
+        reset();
+        start = now_ns();
+        codec.start_decoder();
+        for (uint32_t& symbol : decoded) {
+            symbol = decode(codec);
+        }
+        codec.stop_decoder();
+        best_decode = std::min(best_decode, now_ns() - start);
+
+        if (decoded != c.symbols) {
+            throw std::runtime_error("Round trip failed: " + c.primitive + " " + c.model + " " + c.skew);
+        }
+    }
+
+    micro_result result{ c.primitive
+        , c.model
+        , c.alphabet
+        , c.skew
+        , (c.model.find("data_model") != std::string::npos) && (c.alphabet > 16)
+        , "encode"
+        , static_cast<uint32_t>(c.symbols.size())
+        , double(best_encode)
+        , code_bytes };
+    results.push_back(result);
+
+    result.direction = "decode";
+    result.ns = double(best_decode);
+    results.push_back(result);
+}
+// ----------------------------------------------------------------------------
+static void run_cases(std::vector<micro_case> const& cases
+    , micro_options const& options
+    , std::vector<micro_result>& results)
+{
+    for (micro_case const& c : cases) {
+        std::cerr << c.primitive << " " << c.model << " " << c.alphabet << " " << c.skew << "\n";
+
+        if (c.primitive == "put_bit") {
+            run_case(c, options
+                , [] {}
+                , [](arithmetic_codec& codec, uint32_t symbol) { codec.put_bit(symbol); }
+                , [](arithmetic_codec& codec) { return codec.get_bit(); }
+                , results);
+        } else if (c.primitive == "put_bits") {
+            uint32_t bits(0);
+            while ((1U << bits) < c.alphabet) {
+                ++bits;
+            }
+            run_case(c, options
+                , [] {}
+                , [bits](arithmetic_codec& codec, uint32_t symbol) { codec.put_bits(symbol, bits); }
+                , [bits](arithmetic_codec& codec) { return codec.get_bits(bits); }
+                , results);
+        } else if (c.model == "static_bit_model") {
+            static_bit_model model;
+            model.set_probability_0(c.probability[0]);
+            run_case(c, options
+                , [] {}
+                , [&model](arithmetic_codec& codec, uint32_t symbol) { codec.encode(symbol, model); }
+                , [&model](arithmetic_codec& codec) { return codec.decode(model); }
+                , results);
+        } else if (c.model == "adaptive_bit_model") {
+            adaptive_bit_model model;
+            run_case(c, options
+                , [&model] { model.reset(); }
+                , [&model](arithmetic_codec& codec, uint32_t symbol) { codec.encode(symbol, model); }
+                , [&model](arithmetic_codec& codec) { return codec.decode(model); }
+                , results);
+        } else if (c.model == "static_data_model") {
+            static_data_model model(c.alphabet, c.probability.data());
+            run_case(c, options
+                , [] {}
+                , [&model](arithmetic_codec& codec, uint32_t symbol) { codec.encode(symbol, model); }
+                , [&model](arithmetic_codec& codec) { return codec.decode(model); }
+                , results);
+        } else {
+            adaptive_data_model model(c.alphabet);
+            run_case(c, options
+                , [&model] { model.reset(); }
+                , [&model](arithmetic_codec& codec, uint32_t symbol) { codec.encode(symbol, model); }
+                , [&model](arithmetic_codec& codec) { return codec.decode(model); }
+                , results);
+        }
+    }
+}
+// ----------------------------------------------------------------------------
+static void write_results(std::ostream& output, std::vector<micro_result> const& results)
+{
+    output.precision(15);
+    output << "primitive,model,alphabet,skew,decoder_table,direction,symbols"
+        << ",ns_per_symbol,msymbols_per_s,bits_per_symbol\n";
+    for (micro_result const& r : results) {
+        double const ns_per_symbol(r.ns / double(r.symbol_count));
+        output << r.primitive
+            << "," << r.model
+            << "," << r.alphabet
+            << "," << r.skew
+            << "," << (r.decoder_table ? 1 : 0)
+            << "," << r.direction
+            << "," << r.symbol_count
+            << "," << ns_per_symbol
+            << "," << (ns_per_symbol > 0.0 ? 1000.0 / ns_per_symbol : 0.0)
+            << "," << 8.0 * double(r.code_bytes) / double(r.symbol_count)
+            << "\n";
+    }
+}
+// ============================================================================
+int main(int argc, char* argv[])
+{
+    try {
+        micro_options const options(parse_arguments(argc, argv));
+
+        std::vector<micro_result> results;
+        run_cases(make_cases(options), options, results);
+
+        if (options.output.empty()) {
+            write_results(std::cout, results);
+        } else {
+            std::ofstream file(options.output);
+            if (!file) {
+                throw std::runtime_error("Unable to create " + options.output);
+            }
+            write_results(file, results);
+        }
+    } catch (std::exception const& e) {
+        std::cerr << "Error: " << e.what() << "\n" << USAGE;
+        return 1;
+    }
+    return 0;
+}
+// ============================================================================
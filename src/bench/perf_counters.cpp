@@ -0,0 +1,188 @@
+#include <bench/perf_counters.hpp>
+
+#include <cerrno>
+#include <cstring>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+// ============================================================================
+static char const* const PERF_COUNTER_NAMES[PERF_COUNTER_COUNT] = {
+    "cycles", "instructions", "branch_misses", "l1d_misses", "llc_misses"
+};
+// ----------------------------------------------------------------------------
+char const* perf_counter_name(perf_counter counter)
+{
+    return PERF_COUNTER_NAMES[static_cast<uint32_t>(counter)];
+}
+// ============================================================================
+void perf_values::clear()
+{
+    for (uint32_t i(0); i < PERF_COUNTER_COUNT; ++i) {
+        valid[i] = false;
+        values[i] = 0.0;
+    }
+}
+// ----------------------------------------------------------------------------
+void perf_values::add(perf_values const& other)
+{
+    for (uint32_t i(0); i < PERF_COUNTER_COUNT; ++i) {
+        valid[i] = valid[i] || other.valid[i];
+        values[i] += other.values[i];
+    }
+}
+// ----------------------------------------------------------------------------
+double perf_values::get(perf_counter counter) const
+{
+    return values[static_cast<uint32_t>(counter)];
+}
+// ----------------------------------------------------------------------------
+bool perf_values::has(perf_counter counter) const
+{
+    return valid[static_cast<uint32_t>(counter)];
+}
+// ============================================================================
+#if defined(__linux__)
+static void describe_event(perf_counter counter, perf_event_attr& attr)
+{
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+
+    switch (counter) {
+    case perf_counter::cycles:
+        attr.config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+    case perf_counter::instructions:
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+    case perf_counter::branch_misses:
+        attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+        break;
+    case perf_counter::l1d_misses:
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_L1D
+            | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+            | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        break;
+    case perf_counter::llc_misses:
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        break;
+    }
+
+    // User space only, which perf_event_paranoid <= 2 permits
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP
+        | PERF_FORMAT_TOTAL_TIME_ENABLED
+        | PERF_FORMAT_TOTAL_TIME_RUNNING;
+}
+// ----------------------------------------------------------------------------
+perf_counters::perf_counters()
+    : open_count(0)
+    , leader(-1)
+{
+    for (uint32_t i(0); i < PERF_COUNTER_COUNT; ++i) {
+        descriptors[i] = -1;
+        slots[i] = 0;
+    }
+
+    for (uint32_t i(0); i < PERF_COUNTER_COUNT; ++i) {
+        perf_event_attr attr;
+        describe_event(static_cast<perf_counter>(i), attr);
+        // The leader starts disabled, members follow it
+        attr.disabled = (leader < 0) ? 1 : 0;
+
+        int const fd(static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, leader, 0)));
+        if (fd < 0) {
+            if (failure.empty()) {
+                failure = std::string(perf_counter_name(static_cast<perf_counter>(i)))
+                    + ": " + std::strerror(errno);
+            }
+            continue;
+        }
+
+        descriptors[i] = fd;
+        slots[i] = open_count++;
+        if (leader < 0) {
+            leader = fd;
+        }
+    }
+}
+// ----------------------------------------------------------------------------
+perf_counters::~perf_counters()
+{
+    for (uint32_t i(0); i < PERF_COUNTER_COUNT; ++i) {
+        if (descriptors[i] >= 0) {
+            close(descriptors[i]);
+        }
+    }
+}
+// ----------------------------------------------------------------------------
+void perf_counters::start()
+{
+    if (leader < 0) {
+        return;
+    }
+    ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+// ----------------------------------------------------------------------------
+void perf_counters::stop(perf_values& values)
+{
+    values.clear();
+    if (leader < 0) {
+        return;
+    }
+    ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    // nr, time_enabled, time_running, value[nr]
+    uint64_t data[3 + PERF_COUNTER_COUNT];
+    ssize_t const size(read(leader, data, sizeof(data)));
+    if ((size < ssize_t(3 * sizeof(uint64_t))) || (data[0] != open_count)) {
+        return;
+    }
+
+    // Never scheduled (time_running = 0) means no data
+    if (data[2] == 0) {
+        return;
+    }
+    double const scale(double(data[1]) / double(data[2]));
+
+    for (uint32_t i(0); i < PERF_COUNTER_COUNT; ++i) {
+        if (descriptors[i] >= 0) {
+            values.valid[i] = true;
+            values.values[i] = double(data[3 + slots[i]]) * scale;
+        }
+    }
+}
+#else
+// ----------------------------------------------------------------------------
+perf_counters::perf_counters()
+    : open_count(0)
+    , leader(-1)
+    , failure("hardware counters need Linux perf_event_open")
+{
+    for (uint32_t i(0); i < PERF_COUNTER_COUNT; ++i) {
+        descriptors[i] = -1;
+        slots[i] = 0;
+    }
+}
+// ----------------------------------------------------------------------------
+perf_counters::~perf_counters()
+{
+}
+// ----------------------------------------------------------------------------
+void perf_counters::start()
+{
+}
+// ----------------------------------------------------------------------------
+void perf_counters::stop(perf_values& values)
+{
+    values.clear();
+}
+#endif
+// ============================================================================
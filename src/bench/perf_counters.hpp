@@ -0,0 +1,75 @@
+#pragma once
+// ============================================================================
+#include <cstdint>
+#include <string>
+// ============================================================================
+enum class perf_counter : uint32_t
+{
+    cycles,
+    instructions,
+    branch_misses,
+    l1d_misses,     // L1 data cache read misses
+    llc_misses,     // last level cache misses
+};
+
+static uint32_t const PERF_COUNTER_COUNT(5);
+
+char const* perf_counter_name(perf_counter counter);
+// ----------------------------------------------------------------------------
+struct perf_values
+{
+    // valid[i] = counter i could be opened (and was counting)
+    bool valid[PERF_COUNTER_COUNT];
+    double values[PERF_COUNTER_COUNT];
+
+    void clear();
+    void add(perf_values const& other);
+
+    double get(perf_counter counter) const;
+    bool has(perf_counter counter) const;
+};
+// ============================================================================
+// User space hardware counters of the calling thread (Linux perf_event_open,
+// one counter group read with a single syscall).
+//
+// Never throws: counters the kernel or CPU refuses (perf_event_paranoid,
+// containers, virtual machines without a PMU) are left out, and without any
+// counters available() is false and error() says why. Other platforms have
+// no counters at all.
+class perf_counters
+{
+public:
+    perf_counters();
+    ~perf_counters();
+
+    perf_counters(perf_counters const&) = delete;
+    perf_counters& operator=(perf_counters const&) = delete;
+
+    bool available() const;
+    std::string const& error() const;
+
+    // Zeroes and starts all counters
+    void start();
+    // Stops the counters and stores their values, scaled up if the kernel
+    // had to multiplex them
+    void stop(perf_values& values);
+
+private:
+    int descriptors[PERF_COUNTER_COUNT];
+    // Position of every open counter in the group read
+    uint32_t slots[PERF_COUNTER_COUNT];
+    uint32_t open_count;
+    int leader;
+    std::string failure;
+};
+// ============================================================================
+inline bool perf_counters::available() const
+{
+    return leader >= 0;
+}
+// ----------------------------------------------------------------------------
+inline std::string const& perf_counters::error() const
+{
+    return failure;
+}
+// ============================================================================
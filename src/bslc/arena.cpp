@@ -0,0 +1,59 @@
+#include <bslc/arena.hpp>
+
+#include <algorithm>
+// ============================================================================
+arena::arena(size_t block_size)
+    : block_size(block_size)
+    , current(0)
+    , used(0)
+{
+}
+// ============================================================================
+void* arena::allocate(size_t size)
+{
+    size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+
+    while (current < blocks.size()) {
+        if (used + size <= blocks[current].size) {
+            void* result(blocks[current].data.get() + used);
+            used += size;
+            return result;
+        }
+        ++current;
+        used = 0;
+    }
+
+    block b;
+    b.size = std::max(block_size, size);
+    b.data.reset(new uint8_t[b.size]);
+    blocks.push_back(std::move(b));
+    current = blocks.size() - 1;
+    used = size;
+    return blocks[current].data.get();
+}
+// ----------------------------------------------------------------------------
+void arena::reset()
+{
+    if (blocks.size() > 1) {
+        size_t total(capacity());
+        blocks.clear();
+
+        block b;
+        b.size = total;
+        b.data.reset(new uint8_t[b.size]);
+        blocks.push_back(std::move(b));
+    }
+
+    current = 0;
+    used = 0;
+}
+// ----------------------------------------------------------------------------
+size_t arena::capacity() const
+{
+    size_t total(0);
+    for (auto const& b : blocks) {
+        total += b.size;
+    }
+    return total;
+}
+// ============================================================================
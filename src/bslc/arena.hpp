@@ -0,0 +1,42 @@
+#pragma once
+// ============================================================================
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+// ============================================================================
+// Bump allocator for library state that is set up per list (zlib, bzip2).
+//
+// Individual allocations are never freed; reset() makes all of the memory
+// available again. When a round needed more than one block, reset() merges
+// them into a single block, so from then on the same sequence of allocations
+// never reaches the heap. Not thread safe -- keep one per worker.
+class arena
+{
+public:
+    explicit arena(size_t block_size = 1 << 20);
+
+    arena(arena const&) = delete;
+    arena& operator=(arena const&) = delete;
+
+    void* allocate(size_t size);
+    void reset();
+
+    // Total bytes held, in use or not
+    size_t capacity() const;
+
+private:
+    struct block
+    {
+        std::unique_ptr<uint8_t[]> data;
+        size_t size;
+    };
+
+    static size_t const ALIGNMENT = 16;
+
+    size_t block_size;
+    std::vector<block> blocks;
+    size_t current;
+    size_t used;
+};
+// ============================================================================
@@ -0,0 +1,101 @@
+#include <bslc/arithmetic_codec_v1.hpp>
+
+#include <bslc/bit_set.hpp>
+#include <bslc/bitmap_coding.hpp>
+#include <bslc/size_bounds.hpp>
+#include <bslc/varint.hpp>
+
+#include <fastac/static_bit_model.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+// ============================================================================
+// FastAC limits code buffers to 16 MB
+static size_t const MAX_CODE_BYTES(0x1000000);
+// ============================================================================
+arithmetic_codec_v1::arithmetic_codec_v1(uint64_t universe)
+    : universe(universe)
+{
+    check_universe(universe);
+}
+// ============================================================================
+size_t arithmetic_codec_v1::max_compressed_size(uint32_t match_count) const
+{
+    // Header, match count field, static model bitmap
+    return varint_size(universe) + 9 + static_bit_model_bound(universe, match_count);
+}
+// ----------------------------------------------------------------------------
+size_t arithmetic_codec_v1::decompressed_size(span<uint8_t const> compressed)
+{
+    uint64_t list_universe(0);
+    uint64_t match_count(start_decoder(compressed, list_universe));
+    decoder.stop_decoder();
+    return static_cast<size_t>(match_count);
+}
+// ============================================================================
+size_t arithmetic_codec_v1::compress_into(span<uint32_t const> matches, span<uint8_t> compressed)
+{
+    check_matches(matches, universe);
+
+    size_t offset(0);
+    put_varint(compressed, offset, universe);
+
+    // Code straight into the output, the encoder throws when it runs out
+    size_t const code_bytes(std::min(compressed.size() - offset, MAX_CODE_BYTES));
+    if (code_bytes < 3) {
+        throw std::runtime_error("Output buffer too small.");
+    }
+    encoder.set_buffer(static_cast<uint32_t>(code_bytes), compressed.data() + offset);
+    encoder.start_encoder();
+
+    uint64_t const match_count(matches.size());
+    encoder.put_wide_bits(match_count, bit_width(universe));
+
+    if (match_count > 0) {
+        // Initialize the model
+        static_bit_model model;
+        model.set_probability_0(bitmap_probability_0(match_count, universe));
+
+        // Code all the bitmap entries straight from the match list
+        uint32_t const* match(matches.begin());
+        for (uint64_t i(0); i < universe; ++i) {
+            uint32_t entry((match != matches.end()) && (*match == i));
+            encoder.encode(entry, model);
+            match += entry;
+        }
+    }
+
+    size_t size(encoder.stop_encoder());
+    // Decoder always starts by reading 3 bytes
+    for (; size < 3; ++size) {
+        compressed[offset + size] = 0;
+    }
+    return offset + size;
+}
+// ----------------------------------------------------------------------------
+size_t arithmetic_codec_v1::decompress_into(span<uint8_t const> compressed, span<uint32_t> matches)
+{
+    uint64_t list_universe(0);
+    uint64_t match_count(start_decoder(compressed, list_universe));
+    if (match_count > matches.size()) {
+        decoder.stop_decoder();
+        throw std::runtime_error("Match buffer too small.");
+    }
+
+    // Bits past the last match are all zero, no need to decode them
+    uint64_t const found(decode_static_bitmap(decoder, list_universe, match_count, matches.data()));
+    decoder.stop_decoder();
+    if (found != match_count) {
+        throw std::runtime_error("Corrupted data.");
+    }
+    return static_cast<size_t>(match_count);
+}
+// ============================================================================
+uint64_t arithmetic_codec_v1::start_decoder(span<uint8_t const> compressed, uint64_t& list_universe)
+{
+    size_t offset(0);
+    list_universe = get_varint(compressed, offset);
+    check_universe(list_universe);
+    return start_bitmap_decoder(decoder, compressed, offset, list_universe);
+}
+// ============================================================================
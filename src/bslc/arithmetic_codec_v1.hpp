@@ -0,0 +1,39 @@
+#pragma once
+// ============================================================================
+#include <bslc/codec_base.hpp>
+#include <bslc/match_list.hpp>
+#include <bslc/span.hpp>
+
+#include <fastac/arithmetic_codec.hpp>
+// ============================================================================
+// Bitmap coded with a static bit model derived from the match density
+//
+// Layout:
+//   varint universe
+//   arithmetic code: match_count (bit width of the universe), bitmap
+class arithmetic_codec_v1
+    : public codec_base<arithmetic_codec_v1>
+{
+public:
+    // Universe = number of possible values, at most MAX_UNIVERSE
+    explicit arithmetic_codec_v1(uint64_t universe = NUM_VALUES);
+
+    size_t max_compressed_size(uint32_t match_count) const;
+    size_t decompressed_size(span<uint8_t const> compressed);
+
+    size_t compress_into(span<uint32_t const> matches, span<uint8_t> compressed);
+    size_t decompress_into(span<uint8_t const> compressed, span<uint32_t> matches);
+
+private:
+    // Reads the header and starts the decoder, returns the match count
+    uint64_t start_decoder(span<uint8_t const> compressed, uint64_t& list_universe);
+
+private:
+    uint64_t universe;
+
+    // Long-lived coder state, reused across calls. Both work directly on the
+    // caller's buffers.
+    arithmetic_codec encoder;
+    arithmetic_codec decoder;
+};
+// ============================================================================
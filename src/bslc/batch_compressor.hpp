@@ -0,0 +1,128 @@
+#pragma once
+// ============================================================================
+#include <bslc/match_list.hpp>
+#include <bslc/span.hpp>
+#include <bslc/thread_pool.hpp>
+
+#include <cstring>
+#include <memory>
+#include <vector>
+// ============================================================================
+// Compressed lists stored back to back in one arena.
+// List i occupies arena[offsets[i], offsets[i + 1])
+struct compressed_batch
+{
+    // Arena is padded past the last list, decoders may read a few bytes ahead
+    static size_t const PADDING = 16;
+
+    buffer_t arena;
+    std::vector<uint64_t> offsets;
+
+    size_t size() const;
+    span<uint8_t const> list(size_t index) const;
+};
+// ----------------------------------------------------------------------------
+inline size_t compressed_batch::size() const
+{
+    return offsets.empty() ? 0 : (offsets.size() - 1);
+}
+// ----------------------------------------------------------------------------
+inline span<uint8_t const> compressed_batch::list(size_t index) const
+{
+    return span<uint8_t const>(arena.data() + offsets[index]
+        , static_cast<size_t>(offsets[index + 1] - offsets[index]));
+}
+// ============================================================================
+// Spreads compression of many lists over a thread pool.
+//
+// Every worker owns a long-lived codec and output buffer, so in steady state
+// (same batch sizes) no per-list allocations happen in our code.
+template <typename Codec>
+class batch_compressor
+{
+public:
+    // Codec of each worker is constructed from `args`
+    template <typename... Args>
+    explicit batch_compressor(thread_pool& pool, Args const&... args);
+
+    void compress(span<match_list_t const> lists, compressed_batch& batch);
+    void decompress(compressed_batch const& batch, std::vector<match_list_t>& lists);
+
+private:
+    struct worker_state
+    {
+        std::unique_ptr<Codec> codec;
+        buffer_t output;
+    };
+
+    // Where a list ended up in the worker output
+    struct slot
+    {
+        size_t worker;
+        size_t offset;
+        size_t size;
+    };
+
+private:
+    thread_pool& pool;
+    std::vector<worker_state> workers;
+    std::vector<slot> slots;
+};
+// ============================================================================
+template <typename Codec>
+template <typename... Args>
+batch_compressor<Codec>::batch_compressor(thread_pool& pool, Args const&... args)
+    : pool(pool)
+    , workers(pool.size())
+{
+    for (auto& w : workers) {
+        w.codec = std::make_unique<Codec>(args...);
+    }
+}
+// ----------------------------------------------------------------------------
+template <typename Codec>
+void batch_compressor<Codec>::compress(span<match_list_t const> lists
+    , compressed_batch& batch)
+{
+    for (auto& w : workers) {
+        w.output.clear();
+    }
+    slots.resize(lists.size());
+
+    pool.run(lists.size(), [&](size_t worker, size_t task) {
+        worker_state& w(workers[worker]);
+        slot& s(slots[task]);
+        s.worker = worker;
+        s.offset = w.output.size();
+        s.size = w.codec->compress(lists[task], w.output);
+    });
+
+    // Lay the lists out in input order
+    batch.offsets.resize(lists.size() + 1);
+    batch.offsets[0] = 0;
+    for (size_t i(0); i < lists.size(); ++i) {
+        batch.offsets[i + 1] = batch.offsets[i] + slots[i].size;
+    }
+    batch.arena.resize(static_cast<size_t>(batch.offsets.back()) + compressed_batch::PADDING);
+
+    pool.run(lists.size(), [&](size_t, size_t task) {
+        slot const& s(slots[task]);
+        if (s.size > 0) {
+            std::memcpy(&batch.arena[static_cast<size_t>(batch.offsets[task])]
+                , &workers[s.worker].output[s.offset]
+                , s.size);
+        }
+    });
+}
+// ----------------------------------------------------------------------------
+template <typename Codec>
+void batch_compressor<Codec>::decompress(compressed_batch const& batch
+    , std::vector<match_list_t>& lists)
+{
+    lists.resize(batch.size());
+
+    pool.run(batch.size(), [&](size_t worker, size_t task) {
+        workers[worker].codec->decompress(batch.list(task), lists[task]);
+    });
+}
+// ============================================================================
@@ -0,0 +1,65 @@
+#pragma once
+// ============================================================================
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#if defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+// ============================================================================
+// Bit scan primitives (tzcnt / lzcnt / popcnt)
+inline uint32_t count_trailing_zeros(uint64_t word)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return index;
+#else
+    return static_cast<uint32_t>(__builtin_ctzll(word));
+#endif
+}
+// ----------------------------------------------------------------------------
+// Number of bits needed to store `value` (0 for 0)
+inline uint32_t bit_width(uint64_t value)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    return _BitScanReverse64(&index, value) ? index + 1 : 0;
+#else
+    return (value == 0) ? 0 : 64 - static_cast<uint32_t>(__builtin_clzll(value));
+#endif
+}
+// ----------------------------------------------------------------------------
+inline uint32_t population_count(uint64_t word)
+{
+#if defined(_MSC_VER)
+    return static_cast<uint32_t>(__popcnt64(word));
+#else
+    return static_cast<uint32_t>(__builtin_popcountll(word));
+#endif
+}
+// ----------------------------------------------------------------------------
+// Stores `base + i` for every set bit i of `word` in ascending order, returns
+// the end of the output. `output` needs room for population_count(word) values
+inline uint32_t* extract_bits(uint64_t word, uint32_t base, uint32_t* output)
+{
+#if defined(__AVX512F__)
+    __m512i const lanes(_mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7
+        , 8, 9, 10, 11, 12, 13, 14, 15));
+    for (uint32_t i(0); (i < 64) && (word >> i); i += 16) {
+        __mmask16 mask(static_cast<__mmask16>(word >> i));
+        __m512i values(_mm512_add_epi32(_mm512_set1_epi32(static_cast<int>(base + i)), lanes));
+        _mm512_mask_compressstoreu_epi32(output, mask, values);
+        output += population_count(mask);
+    }
+#else
+    while (word != 0) {
+        *output++ = base + count_trailing_zeros(word);
+        word &= word - 1; // blsr
+    }
+#endif
+    return output;
+}
+// ============================================================================
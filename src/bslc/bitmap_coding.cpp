@@ -0,0 +1,82 @@
+#include <bslc/bitmap_coding.hpp>
+
+#include <bslc/bit_set.hpp>
+
+#include <fastac/static_bit_model.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+// ============================================================================
+// FastAC limits code buffers to 16 MB
+static size_t const MAX_CODE_BYTES(0x1000000);
+// ============================================================================
+double bitmap_probability_0(uint64_t match_count, uint64_t num_values)
+{
+    double probability_0(double(num_values - match_count) / double(num_values));
+    // Limit probability to match FastAC limitations...
+    return std::max(0.0001, std::min(0.9999, probability_0));
+}
+// ============================================================================
+void encode_static_bitmap(arithmetic_codec& encoder, span<uint32_t const> matches, uint64_t universe)
+{
+    encoder.put_wide_bits(matches.size(), bit_width(universe));
+    if (matches.empty()) {
+        return;
+    }
+
+    static_bit_model model;
+    model.set_probability_0(bitmap_probability_0(matches.size(), universe));
+    uint64_t position(0);
+    for (uint32_t match : matches) {
+        for (; position < match; ++position) {
+            encoder.encode(0, model);
+        }
+        encoder.encode(1, model);
+        ++position;
+    }
+}
+// ----------------------------------------------------------------------------
+uint64_t decode_static_bitmap(arithmetic_codec& decoder
+    , uint64_t list_universe
+    , uint64_t match_count
+    , uint32_t* output)
+{
+    if (match_count == 0) {
+        return 0;
+    }
+
+    static_bit_model model;
+    model.set_probability_0(bitmap_probability_0(match_count, list_universe));
+    // Bits past the last match are all zero, no need to decode them
+    uint64_t found(0);
+    for (uint64_t i(0); (i < list_universe) && (found < match_count); ++i) {
+        if (decoder.decode(model) == 1) {
+            output[found++] = static_cast<uint32_t>(i);
+        }
+    }
+    return found;
+}
+// ============================================================================
+uint64_t start_bitmap_decoder(arithmetic_codec& decoder
+    , span<uint8_t const> compressed
+    , size_t offset
+    , uint64_t list_universe)
+{
+    size_t const code_bytes(std::min(compressed.size() - offset, MAX_CODE_BYTES));
+    if (code_bytes < 3) {
+        throw std::runtime_error("Truncated header.");
+    }
+
+    // Decoder only reads from the buffer
+    decoder.set_buffer(static_cast<uint32_t>(code_bytes)
+        , const_cast<uint8_t*>(compressed.data() + offset));
+    decoder.start_decoder();
+
+    uint64_t const match_count(decoder.get_wide_bits(bit_width(list_universe)));
+    if (match_count > list_universe) {
+        decoder.stop_decoder();
+        throw std::runtime_error("Invalid match count.");
+    }
+    return match_count;
+}
+// ============================================================================
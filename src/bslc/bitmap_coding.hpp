@@ -0,0 +1,36 @@
+#pragma once
+// ============================================================================
+#include <bslc/span.hpp>
+
+#include <fastac/arithmetic_codec.hpp>
+
+#include <cstddef>
+#include <cstdint>
+// ============================================================================
+// Pieces shared by the arithmetic coded bitmap codecs (v1, v2, segmented,
+// interleaved, mixing, template).
+// ============================================================================
+// Probability of a zero among `num_values` bits holding `match_count` ones,
+// limited to what static_bit_model can represent
+double bitmap_probability_0(uint64_t match_count, uint64_t num_values);
+// ----------------------------------------------------------------------------
+// Codes the bitmap of `matches` up to the last match with a static model set
+// to the density, after the match count in the bit width of the universe.
+// The fallback of the adaptive bitmap codecs, decoded by
+// start_bitmap_decoder and decode_static_bitmap
+void encode_static_bitmap(arithmetic_codec& encoder, span<uint32_t const> matches, uint64_t universe);
+// Decodes up to `match_count` matches coded as above into `output`, returns
+// how many were found (fewer only on corrupt data)
+uint64_t decode_static_bitmap(arithmetic_codec& decoder
+    , uint64_t list_universe
+    , uint64_t match_count
+    , uint32_t* output);
+// ----------------------------------------------------------------------------
+// Starts `decoder` on the code at compressed[offset] and reads the match
+// count the bitmap codecs start with. Throws if there is no code or the
+// count exceeds the universe, the decoder is stopped again then
+uint64_t start_bitmap_decoder(arithmetic_codec& decoder
+    , span<uint8_t const> compressed
+    , size_t offset
+    , uint64_t list_universe);
+// ============================================================================
@@ -0,0 +1,174 @@
+#include <bslc/bzip2_codec.hpp>
+
+#include <bslc/varint.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+// ============================================================================
+static void* arena_alloc(void* opaque, int items, int size)
+{
+    return static_cast<arena*>(opaque)->allocate(size_t(items) * size);
+}
+// ----------------------------------------------------------------------------
+static void arena_free(void*, void*)
+{
+    // Released with the arena
+}
+// ----------------------------------------------------------------------------
+static uint64_t total_out(bz_stream const& stream)
+{
+    return (uint64_t(stream.total_out_hi32) << 32) | stream.total_out_lo32;
+}
+// ============================================================================
+bzip2_codec::bzip2_codec(uint32_t bits_per_symbol, uint64_t universe)
+    : bits_per_symbol(bits_per_symbol)
+    , universe(universe)
+    , chunk(BITMAP_CHUNK_SIZE)
+{
+    check_universe(universe);
+
+    stream.bzalloc = arena_alloc;
+    stream.bzfree = arena_free;
+    stream.opaque = &memory;
+}
+// ============================================================================
+size_t bzip2_codec::max_compressed_size(uint32_t match_count) const
+{
+    // Worst case documented for BZ2_bzBuffToBuffCompress
+    size_t size(symbol_count(static_cast<uint8_t>(bits_per_symbol), universe));
+    return varint_size(universe) + varint_size(match_count) + size + size / 100 + 600;
+}
+// ----------------------------------------------------------------------------
+size_t bzip2_codec::decompressed_size(span<uint8_t const> compressed)
+{
+    size_t offset(0);
+    check_universe(get_varint(compressed, offset));
+    return static_cast<size_t>(get_varint(compressed, offset));
+}
+// ============================================================================
+size_t bzip2_codec::compress_into(span<uint32_t const> matches, span<uint8_t> compressed)
+{
+    check_matches(matches, universe);
+
+    size_t offset(0);
+    put_varint(compressed, offset, universe);
+    put_varint(compressed, offset, matches.size());
+
+    // One block holds the whole bitmap, anything larger only costs memory
+    size_t const total(symbol_count(static_cast<uint8_t>(bits_per_symbol), universe));
+    int block_size(static_cast<int>(std::min<size_t>(9, total / 100000 + 1)));
+
+    memory.reset();
+    if (BZ2_bzCompressInit(&stream, block_size, 0, 30) != BZ_OK) {
+        throw std::runtime_error("Compression error.");
+    }
+
+    stream.next_out = (char*)compressed.data() + offset;
+    stream.avail_out = static_cast<uint32_t>(compressed.size() - offset);
+
+    // Generate the bitmap a chunk at a time and stream it through bzip2
+    size_t consumed(0);
+    for (size_t first(0); first < total; first += BITMAP_CHUNK_SIZE) {
+        size_t size(std::min(BITMAP_CHUNK_SIZE, total - first));
+        consumed += make_symbols(matches.subspan(consumed)
+            , static_cast<uint8_t>(bits_per_symbol)
+            , first
+            , span<uint8_t>(chunk.data(), size));
+
+        stream.next_in = (char*)chunk.data();
+        stream.avail_in = static_cast<uint32_t>(size);
+        if ((BZ2_bzCompress(&stream, BZ_RUN) != BZ_RUN_OK) || (stream.avail_in > 0)) {
+            BZ2_bzCompressEnd(&stream);
+            throw std::runtime_error("Output buffer too small.");
+        }
+    }
+
+    int err;
+    do {
+        err = BZ2_bzCompress(&stream, BZ_FINISH);
+    } while ((err == BZ_FINISH_OK) && (stream.avail_out > 0));
+
+    size_t compressed_size(static_cast<size_t>(total_out(stream)));
+    BZ2_bzCompressEnd(&stream);
+
+    if (err == BZ_FINISH_OK) {
+        throw std::runtime_error("Output buffer too small.");
+    }
+    if (err != BZ_STREAM_END) {
+        throw std::runtime_error("Compression error.");
+    }
+    if (consumed != matches.size()) {
+        throw std::runtime_error("Match out of range.");
+    }
+
+    return offset + compressed_size;
+}
+// ----------------------------------------------------------------------------
+size_t bzip2_codec::decompress_into(span<uint8_t const> compressed, span<uint32_t> matches)
+{
+    size_t offset(0);
+    uint64_t const list_universe(get_varint(compressed, offset));
+    check_universe(list_universe);
+    uint64_t match_count(get_varint(compressed, offset));
+    if (match_count > list_universe) {
+        throw std::runtime_error("Invalid match count.");
+    }
+    if (match_count > matches.size()) {
+        throw std::runtime_error("Match buffer too small.");
+    }
+
+    memory.reset();
+    if (BZ2_bzDecompressInit(&stream, 0, 0) != BZ_OK) {
+        throw std::runtime_error("Decompression error.");
+    }
+
+    stream.next_in = (char*)compressed.data() + offset;
+    stream.avail_in = static_cast<uint32_t>(compressed.size() - offset);
+
+    // Decompress a chunk at a time, extracting the matches as we go
+    size_t const total(symbol_count(static_cast<uint8_t>(bits_per_symbol), list_universe));
+    size_t count(0);
+    int err(BZ_OK);
+    for (size_t first(0); (first < total) && (err == BZ_OK); first += BITMAP_CHUNK_SIZE) {
+        size_t size(std::min(BITMAP_CHUNK_SIZE, total - first));
+        stream.next_out = (char*)chunk.data();
+        stream.avail_out = static_cast<uint32_t>(size);
+
+        do {
+            err = BZ2_bzDecompress(&stream);
+        } while ((err == BZ_OK) && (stream.avail_in > 0) && (stream.avail_out > 0));
+        if (stream.avail_out > 0) {
+            break;
+        }
+
+        count = make_matches(span<uint8_t const>(chunk.data(), size)
+            , static_cast<uint8_t>(bits_per_symbol)
+            , first
+            , matches.first(static_cast<size_t>(match_count))
+            , count);
+    }
+
+    // The end of stream marker may still be pending when the bitmap fills
+    // the last chunk exactly
+    if ((err == BZ_OK) && (total_out(stream) == total)) {
+        char extra(0);
+        stream.next_out = &extra;
+        stream.avail_out = 1;
+        err = BZ2_bzDecompress(&stream);
+    }
+
+    uint64_t decompressed_size(total_out(stream));
+    BZ2_bzDecompressEnd(&stream);
+
+    if (err != BZ_STREAM_END) {
+        throw std::runtime_error("Decompression error.");
+    }
+    if (decompressed_size != total) {
+        throw std::runtime_error("Size mismatch.");
+    }
+    if (count != match_count) {
+        throw std::runtime_error("Size mismatch.");
+    }
+    return count;
+}
+// ============================================================================
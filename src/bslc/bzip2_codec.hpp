@@ -0,0 +1,48 @@
+#pragma once
+// ============================================================================
+#include <bslc/arena.hpp>
+#include <bslc/codec_base.hpp>
+#include <bslc/match_list.hpp>
+#include <bslc/span.hpp>
+
+#include <bzlib.h>
+// ============================================================================
+// Bitmap with `bits_per_symbol` values per byte, compressed with bzip2
+//
+// Layout:
+//   varint universe
+//   varint match_count
+//   compressed bitmap
+//
+// The bitmap is never materialized: it is generated and consumed in
+// BITMAP_CHUNK_SIZE slices that stream through the library.
+//
+// bzip2 has no way to reset a stream, so each list still runs Init/End, but
+// all of the stream state comes from a private arena that is recycled
+// between lists. The block size is the smallest that fits the bitmap.
+class bzip2_codec
+    : public codec_base<bzip2_codec>
+{
+public:
+    // Universe = number of possible values, at most MAX_UNIVERSE
+    explicit bzip2_codec(uint32_t bits_per_symbol, uint64_t universe = NUM_VALUES);
+
+    bzip2_codec(bzip2_codec const&) = delete;
+    bzip2_codec& operator=(bzip2_codec const&) = delete;
+
+    size_t max_compressed_size(uint32_t match_count) const;
+    size_t decompressed_size(span<uint8_t const> compressed);
+
+    size_t compress_into(span<uint32_t const> matches, span<uint8_t> compressed);
+    size_t decompress_into(span<uint8_t const> compressed, span<uint32_t> matches);
+
+private:
+    uint32_t bits_per_symbol;
+    uint64_t universe;
+    // Bitmap slice streaming through the library
+    match_symbols_t chunk;
+
+    arena memory;
+    bz_stream stream;
+};
+// ============================================================================
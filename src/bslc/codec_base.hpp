@@ -0,0 +1,70 @@
+#pragma once
+// ============================================================================
+#include <bslc/match_list.hpp>
+#include <bslc/span.hpp>
+// ============================================================================
+// Vector based convenience interface, implemented on top of the span based
+// interface every codec provides:
+//
+//   size_t max_compressed_size(uint32_t match_count) const;
+//   size_t decompressed_size(span<uint8_t const> compressed);
+//   size_t compress_into(span<uint32_t const> matches, span<uint8_t> compressed);
+//   size_t decompress_into(span<uint8_t const> compressed, span<uint32_t> matches);
+//
+// The `_into` functions return the number of elements written and throw when
+// the destination is too small. They never allocate once the codec is warm.
+template <typename Codec>
+class codec_base
+{
+public:
+    buffer_t compress(match_list_t const& matches);
+    // Appends to `compressed`, returns number of bytes appended
+    size_t compress(match_list_t const& matches, buffer_t& compressed);
+
+    match_list_t decompress(span<uint8_t const> compressed);
+    void decompress(span<uint8_t const> compressed, match_list_t& matches);
+
+private:
+    Codec& self();
+};
+// ============================================================================
+template <typename Codec>
+inline Codec& codec_base<Codec>::self()
+{
+    return static_cast<Codec&>(*this);
+}
+// ----------------------------------------------------------------------------
+template <typename Codec>
+inline buffer_t codec_base<Codec>::compress(match_list_t const& matches)
+{
+    buffer_t compressed;
+    compress(matches, compressed);
+    return compressed;
+}
+// ----------------------------------------------------------------------------
+template <typename Codec>
+inline size_t codec_base<Codec>::compress(match_list_t const& matches, buffer_t& compressed)
+{
+    size_t const offset(compressed.size());
+    compressed.resize(offset + self().max_compressed_size(static_cast<uint32_t>(matches.size())));
+
+    size_t size(self().compress_into(matches, span<uint8_t>(compressed).subspan(offset)));
+    compressed.resize(offset + size);
+    return size;
+}
+// ----------------------------------------------------------------------------
+template <typename Codec>
+inline match_list_t codec_base<Codec>::decompress(span<uint8_t const> compressed)
+{
+    match_list_t matches;
+    decompress(compressed, matches);
+    return matches;
+}
+// ----------------------------------------------------------------------------
+template <typename Codec>
+inline void codec_base<Codec>::decompress(span<uint8_t const> compressed, match_list_t& matches)
+{
+    matches.resize(self().decompressed_size(compressed));
+    self().decompress_into(compressed, matches);
+}
+// ============================================================================
@@ -0,0 +1,219 @@
+#include <bslc/corpus.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+// ============================================================================
+// Fields are stored in host order, every platform we build on is little endian
+static char const CORPUS_MAGIC[8] = { 'B', 'S', 'L', 'C', 'O', 'R', 'P', '1' };
+static size_t const HEADER_SIZE(16);
+static size_t const ENTRY_SIZE(24);
+// ============================================================================
+void corpus_writer::add(span<uint32_t const> matches, uint64_t universe, workload_kind kind)
+{
+    check_universe(universe);
+    check_matches(matches, universe);
+
+    list_info info;
+    info.universe = universe;
+    info.first = values.size();
+    info.match_count = static_cast<uint32_t>(matches.size());
+    info.kind = kind;
+    lists.push_back(info);
+
+    values.insert(values.end(), matches.begin(), matches.end());
+    // Keep every list 8 byte aligned
+    if (values.size() % 2 != 0) {
+        values.push_back(0);
+    }
+}
+// ----------------------------------------------------------------------------
+void corpus_writer::write(std::string const& path) const
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        throw std::runtime_error("Unable to create " + path);
+    }
+
+    uint64_t const list_count(lists.size());
+    file.write(CORPUS_MAGIC, sizeof(CORPUS_MAGIC));
+    file.write(reinterpret_cast<char const*>(&list_count), sizeof(list_count));
+
+    uint64_t const data_offset(HEADER_SIZE + ENTRY_SIZE * lists.size());
+    for (list_info const& info : lists) {
+        uint8_t entry[ENTRY_SIZE] = {};
+        uint64_t const offset(data_offset + info.first * sizeof(uint32_t));
+        std::memcpy(entry, &info.universe, 8);
+        std::memcpy(entry + 8, &offset, 8);
+        std::memcpy(entry + 16, &info.match_count, 4);
+        entry[20] = static_cast<uint8_t>(info.kind);
+        file.write(reinterpret_cast<char const*>(entry), ENTRY_SIZE);
+    }
+
+    file.write(reinterpret_cast<char const*>(values.data())
+        , static_cast<std::streamsize>(values.size() * sizeof(uint32_t)));
+    if (!file.flush()) {
+        throw std::runtime_error("Unable to write " + path);
+    }
+}
+// ============================================================================
+corpus_file::corpus_file(std::string const& path)
+    : data(nullptr)
+    , data_size(0)
+    , entries(nullptr)
+    , list_count(0)
+#if defined(_WIN32)
+    , file_handle(INVALID_HANDLE_VALUE)
+    , mapping_handle(nullptr)
+#else
+    , file_descriptor(-1)
+#endif
+{
+    static_assert(sizeof(entry) == ENTRY_SIZE, "Corpus entry layout");
+
+    map(path);
+    try {
+        if ((data_size < HEADER_SIZE) || (std::memcmp(data, CORPUS_MAGIC, sizeof(CORPUS_MAGIC)) != 0)) {
+            throw std::runtime_error("Not a corpus file: " + path);
+        }
+
+        uint64_t count(0);
+        std::memcpy(&count, data + 8, sizeof(count));
+        if (count > (data_size - HEADER_SIZE) / ENTRY_SIZE) {
+            throw std::runtime_error("Truncated corpus file: " + path);
+        }
+        list_count = static_cast<size_t>(count);
+        entries = reinterpret_cast<entry const*>(data + HEADER_SIZE);
+
+        // Validate the index once, so the accessors needn't
+        for (size_t i(0); i < list_count; ++i) {
+            entry const& e(entries[i]);
+            if ((e.offset % 8 != 0)
+                || (e.offset > data_size)
+                || (uint64_t(e.match_count) > (data_size - e.offset) / sizeof(uint32_t))
+                || (e.kind >= WORKLOAD_KIND_COUNT)
+                || (e.universe == 0)
+                || (e.universe > MAX_UNIVERSE)
+                || (e.match_count > e.universe)) {
+                throw std::runtime_error("Corrupted corpus file: " + path);
+            }
+        }
+    } catch (...) {
+        unmap();
+        throw;
+    }
+}
+// ----------------------------------------------------------------------------
+corpus_file::~corpus_file()
+{
+    unmap();
+}
+// ============================================================================
+span<uint32_t const> corpus_file::matches(size_t index) const
+{
+    entry const& e(entries[index]);
+    return span<uint32_t const>(reinterpret_cast<uint32_t const*>(data + e.offset), e.match_count);
+}
+// ----------------------------------------------------------------------------
+uint64_t corpus_file::universe(size_t index) const
+{
+    return entries[index].universe;
+}
+// ----------------------------------------------------------------------------
+workload_kind corpus_file::kind(size_t index) const
+{
+    return static_cast<workload_kind>(entries[index].kind);
+}
+// ============================================================================
+#if defined(_WIN32)
+void corpus_file::map(std::string const& path)
+{
+    file_handle = CreateFileA(path.c_str()
+        , GENERIC_READ
+        , FILE_SHARE_READ
+        , nullptr
+        , OPEN_EXISTING
+        , FILE_ATTRIBUTE_NORMAL
+        , nullptr);
+    if (file_handle == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Unable to open " + path);
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file_handle, &file_size) || (file_size.QuadPart == 0)) {
+        unmap();
+        throw std::runtime_error("Not a corpus file: " + path);
+    }
+    data_size = static_cast<size_t>(file_size.QuadPart);
+
+    mapping_handle = CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* view(mapping_handle ? MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0) : nullptr);
+    if (view == nullptr) {
+        unmap();
+        throw std::runtime_error("Unable to map " + path);
+    }
+    data = static_cast<uint8_t const*>(view);
+}
+// ----------------------------------------------------------------------------
+void corpus_file::unmap()
+{
+    if (data != nullptr) {
+        UnmapViewOfFile(data);
+        data = nullptr;
+    }
+    if (mapping_handle != nullptr) {
+        CloseHandle(mapping_handle);
+        mapping_handle = nullptr;
+    }
+    if (file_handle != INVALID_HANDLE_VALUE) {
+        CloseHandle(file_handle);
+        file_handle = INVALID_HANDLE_VALUE;
+    }
+}
+#else
+// ----------------------------------------------------------------------------
+void corpus_file::map(std::string const& path)
+{
+    file_descriptor = ::open(path.c_str(), O_RDONLY);
+    if (file_descriptor < 0) {
+        throw std::runtime_error("Unable to open " + path);
+    }
+
+    struct stat file_stat;
+    if ((::fstat(file_descriptor, &file_stat) != 0) || (file_stat.st_size == 0)) {
+        unmap();
+        throw std::runtime_error("Not a corpus file: " + path);
+    }
+    data_size = static_cast<size_t>(file_stat.st_size);
+
+    void* view(::mmap(nullptr, data_size, PROT_READ, MAP_SHARED, file_descriptor, 0));
+    if (view == MAP_FAILED) {
+        unmap();
+        throw std::runtime_error("Unable to map " + path);
+    }
+    data = static_cast<uint8_t const*>(view);
+}
+// ----------------------------------------------------------------------------
+void corpus_file::unmap()
+{
+    if (data != nullptr) {
+        ::munmap(const_cast<uint8_t*>(data), data_size);
+        data = nullptr;
+    }
+    if (file_descriptor >= 0) {
+        ::close(file_descriptor);
+        file_descriptor = -1;
+    }
+}
+#endif
+// ============================================================================
@@ -0,0 +1,98 @@
+#pragma once
+// ============================================================================
+#include <bslc/match_list.hpp>
+#include <bslc/span.hpp>
+#include <bslc/workload.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+// ============================================================================
+// Benchmark corpus: a set of match lists in one binary file, memory mapped
+// so the lists are read in place, without parsing or copying.
+//
+// Layout (little endian):
+//   char[8]  magic "BSLCORP1"
+//   uint64   list_count
+//   list_count x entry
+//     uint64   universe
+//     uint64   offset (from the start of the file, multiple of 8)
+//     uint32   match_count
+//     uint8    workload_kind
+//     uint8[3] zero
+//   match lists, uint32 values
+// ============================================================================
+class corpus_writer
+{
+public:
+    void add(span<uint32_t const> matches, uint64_t universe, workload_kind kind);
+    // Throws on I/O errors
+    void write(std::string const& path) const;
+
+    size_t size() const;
+
+private:
+    struct list_info
+    {
+        uint64_t universe;
+        size_t first;
+        uint32_t match_count;
+        workload_kind kind;
+    };
+
+    std::vector<list_info> lists;
+    match_list_t values;
+};
+// ----------------------------------------------------------------------------
+class corpus_file
+{
+public:
+    // Maps the file read-only, throws if it is missing or malformed
+    explicit corpus_file(std::string const& path);
+    ~corpus_file();
+
+    corpus_file(corpus_file const&) = delete;
+    corpus_file& operator=(corpus_file const&) = delete;
+
+    size_t size() const;
+
+    span<uint32_t const> matches(size_t index) const;
+    uint64_t universe(size_t index) const;
+    workload_kind kind(size_t index) const;
+
+private:
+    struct entry
+    {
+        uint64_t universe;
+        uint64_t offset;
+        uint32_t match_count;
+        uint8_t kind;
+        uint8_t reserved[3];
+    };
+
+    void map(std::string const& path);
+    void unmap();
+
+private:
+    uint8_t const* data;
+    size_t data_size;
+    entry const* entries;
+    size_t list_count;
+#if defined(_WIN32)
+    void* file_handle;
+    void* mapping_handle;
+#else
+    int file_descriptor;
+#endif
+};
+// ============================================================================
+inline size_t corpus_writer::size() const
+{
+    return lists.size();
+}
+// ----------------------------------------------------------------------------
+inline size_t corpus_file::size() const
+{
+    return list_count;
+}
+// ============================================================================
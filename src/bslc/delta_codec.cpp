@@ -0,0 +1,259 @@
+#include <bslc/delta_codec.hpp>
+
+#include <bslc/gap_coding.hpp>
+#include <bslc/varint.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+// ============================================================================
+// FastAC limits code buffers to 16 MB
+static size_t const MAX_CODE_BYTES(0x1000000);
+// Gap bit lengths 0 ... 32
+static uint32_t const LENGTH_SYMBOLS(33);
+// Event kinds
+static uint32_t const ADDITION(0);
+static uint32_t const REMOVAL(1);
+// ============================================================================
+// Order dependent hash of the reference, updated one match at a time
+static uint32_t const FINGERPRINT_SEED(0x811C9DC5U);
+// ----------------------------------------------------------------------------
+static uint32_t fingerprint(uint32_t hash, uint32_t match)
+{
+    return (hash ^ match) * 0x9E3779B1U;
+}
+// ============================================================================
+delta_codec::delta_codec(uint64_t universe)
+    : universe(universe)
+    , removal_model(LENGTH_SYMBOLS)
+    , addition_model(LENGTH_SYMBOLS)
+{
+    check_universe(universe);
+}
+// ============================================================================
+size_t delta_codec::max_delta_size(uint32_t reference_count, uint32_t match_count) const
+{
+    // Every match is at most one event: kind bit and length cost at most
+    // ~28 bits, mantissas at most 31 bits
+    uint64_t const events(uint64_t(reference_count) + match_count);
+    return varint_size(universe) + varint_size(reference_count) + varint_size(FINGERPRINT_SEED)
+        + varint_size(reference_count) + varint_size(match_count)
+        + static_cast<size_t>(events) * 8 + 16;
+}
+// ----------------------------------------------------------------------------
+size_t delta_codec::applied_size(span<uint8_t const> delta)
+{
+    size_t offset(0);
+    uint64_t const list_universe(get_varint(delta, offset));
+    uint64_t const reference_count(get_varint(delta, offset));
+    get_varint(delta, offset);
+    uint64_t const removal_count(get_varint(delta, offset));
+    uint64_t const addition_count(get_varint(delta, offset));
+    if ((removal_count > reference_count) || (addition_count > list_universe)
+        || (reference_count - removal_count + addition_count > list_universe)) {
+        throw std::runtime_error("Invalid event count.");
+    }
+    return static_cast<size_t>(reference_count - removal_count + addition_count);
+}
+// ============================================================================
+size_t delta_codec::delta_into(span<uint32_t const> reference
+    , span<uint32_t const> matches
+    , span<uint8_t> delta)
+{
+    check_matches(reference, universe);
+    check_matches(matches, universe);
+
+    // The header needs the counts before any event is coded
+    uint32_t hash(FINGERPRINT_SEED);
+    size_t removal_count(0);
+    size_t addition_count(0);
+    {
+        size_t r(0);
+        size_t m(0);
+        while ((r < reference.size()) || (m < matches.size())) {
+            if ((m == matches.size()) || ((r < reference.size()) && (reference[r] < matches[m]))) {
+                hash = fingerprint(hash, reference[r++]);
+                ++removal_count;
+            } else if ((r == reference.size()) || (matches[m] < reference[r])) {
+                ++m;
+                ++addition_count;
+            } else {
+                hash = fingerprint(hash, reference[r++]);
+                ++m;
+            }
+        }
+    }
+
+    size_t offset(0);
+    put_varint(delta, offset, universe);
+    put_varint(delta, offset, reference.size());
+    put_varint(delta, offset, hash);
+    put_varint(delta, offset, removal_count);
+    put_varint(delta, offset, addition_count);
+    if (removal_count + addition_count == 0) {
+        return offset;
+    }
+
+    // Code straight into the output, the encoder throws when it runs out
+    size_t const code_bytes(std::min(delta.size() - offset, MAX_CODE_BYTES));
+    if (code_bytes < 3) {
+        throw std::runtime_error("Output buffer too small.");
+    }
+    encoder.set_buffer(static_cast<uint32_t>(code_bytes), delta.data() + offset);
+    encoder.start_encoder();
+    kind_model.reset();
+    removal_model.reset();
+    addition_model.reset();
+
+    // `copied` = reference index past the last event (what apply has copied
+    // by then), `next` = value past the last event
+    size_t r(0);
+    size_t m(0);
+    size_t copied(0);
+    uint64_t next(0);
+    while ((removal_count != 0) || (addition_count != 0)) {
+        if ((m == matches.size()) || ((r < reference.size()) && (reference[r] < matches[m]))) {
+            if (addition_count != 0) {
+                encoder.encode(REMOVAL, kind_model);
+            }
+            encode_gap(encoder, removal_model, static_cast<uint32_t>(r - copied));
+            next = uint64_t(reference[r]) + 1;
+            copied = ++r;
+            --removal_count;
+        } else if ((r == reference.size()) || (matches[m] < reference[r])) {
+            if (removal_count != 0) {
+                encoder.encode(ADDITION, kind_model);
+            }
+            encode_gap(encoder, addition_model, static_cast<uint32_t>(matches[m] - next));
+            next = uint64_t(matches[m++]) + 1;
+            copied = r;
+            --addition_count;
+        } else {
+            ++r;
+            ++m;
+        }
+    }
+
+    size_t size(encoder.stop_encoder());
+    // Decoder always starts by reading 3 bytes
+    for (; size < 3; ++size) {
+        delta[offset + size] = 0;
+    }
+    return offset + size;
+}
+// ----------------------------------------------------------------------------
+size_t delta_codec::apply_into(span<uint32_t const> reference
+    , span<uint8_t const> delta
+    , span<uint32_t> matches)
+{
+    size_t offset(0);
+    uint64_t const list_universe(get_varint(delta, offset));
+    check_universe(list_universe);
+    uint64_t const reference_count(get_varint(delta, offset));
+    uint64_t const reference_hash(get_varint(delta, offset));
+    uint64_t removal_count(get_varint(delta, offset));
+    uint64_t addition_count(get_varint(delta, offset));
+    if (reference_count != reference.size()) {
+        throw std::runtime_error("Delta was made against another reference list.");
+    }
+    if ((removal_count > reference_count) || (addition_count > list_universe)) {
+        throw std::runtime_error("Invalid event count.");
+    }
+    uint64_t const match_count(reference_count - removal_count + addition_count);
+    if (match_count > list_universe) {
+        throw std::runtime_error("Invalid event count.");
+    }
+    if (match_count > matches.size()) {
+        throw std::runtime_error("Match buffer too small.");
+    }
+
+    bool const coded((removal_count != 0) || (addition_count != 0));
+    if (coded) {
+        size_t const code_bytes(std::min(delta.size() - offset, MAX_CODE_BYTES));
+        if (code_bytes < 3) {
+            throw std::runtime_error("Truncated header.");
+        }
+
+        // Decoder only reads from the buffer
+        decoder.set_buffer(static_cast<uint32_t>(code_bytes)
+            , const_cast<uint8_t*>(delta.data() + offset));
+        decoder.start_decoder();
+        kind_model.reset();
+        removal_model.reset();
+        addition_model.reset();
+    }
+
+    uint32_t hash(FINGERPRINT_SEED);
+    size_t r(0);
+    size_t count(0);
+    uint64_t next(0);
+    while ((removal_count != 0) || (addition_count != 0)) {
+        uint32_t kind(removal_count != 0 ? REMOVAL : ADDITION);
+        if ((removal_count != 0) && (addition_count != 0)) {
+            kind = decoder.decode(kind_model);
+        }
+
+        if (kind == REMOVAL) {
+            // The remaining removals each need a match of their own
+            uint64_t const skip(decode_gap(decoder, removal_model));
+            if (skip > reference.size() - r - removal_count) {
+                decoder.stop_decoder();
+                throw std::runtime_error("Removal out of range.");
+            }
+            for (size_t const end(r + static_cast<size_t>(skip)); r < end; ++r) {
+                hash = fingerprint(hash, reference[r]);
+                matches[count++] = reference[r];
+            }
+            hash = fingerprint(hash, reference[r]);
+            next = uint64_t(reference[r++]) + 1;
+            --removal_count;
+        } else {
+            uint64_t const gap(decode_gap(decoder, addition_model));
+            if (gap >= list_universe - next) {
+                decoder.stop_decoder();
+                throw std::runtime_error("Match out of range.");
+            }
+            uint64_t const match(next + gap);
+            size_t const copy_end(reference.size() - static_cast<size_t>(removal_count));
+            for (; (r < copy_end) && (reference[r] < match); ++r) {
+                hash = fingerprint(hash, reference[r]);
+                matches[count++] = reference[r];
+            }
+            if ((r < reference.size()) && (reference[r] <= match)) {
+                decoder.stop_decoder();
+                throw std::runtime_error("Invalid delta.");
+            }
+            matches[count++] = static_cast<uint32_t>(match);
+            next = match + 1;
+            --addition_count;
+        }
+    }
+    if (coded) {
+        decoder.stop_decoder();
+    }
+
+    // Past the last event the reference is copied as is
+    for (; r < reference.size(); ++r) {
+        hash = fingerprint(hash, reference[r]);
+        matches[count++] = reference[r];
+    }
+    if (hash != reference_hash) {
+        throw std::runtime_error("Delta was made against another reference list.");
+    }
+    return count;
+}
+// ============================================================================
+buffer_t delta_codec::delta(match_list_t const& reference, match_list_t const& matches)
+{
+    buffer_t compressed(max_delta_size(static_cast<uint32_t>(reference.size())
+        , static_cast<uint32_t>(matches.size())));
+    compressed.resize(delta_into(reference, matches, compressed));
+    return compressed;
+}
+// ----------------------------------------------------------------------------
+match_list_t delta_codec::apply(match_list_t const& reference, span<uint8_t const> delta)
+{
+    match_list_t matches(applied_size(delta));
+    matches.resize(apply_into(reference, delta, matches));
+    return matches;
+}
+// ============================================================================
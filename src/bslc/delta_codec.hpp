@@ -0,0 +1,68 @@
+#pragma once
+// ============================================================================
+#include <bslc/match_list.hpp>
+#include <bslc/span.hpp>
+
+#include <fastac/adaptive_bit_model.hpp>
+#include <fastac/adaptive_data_model.hpp>
+#include <fastac/arithmetic_codec.hpp>
+
+#include <cstdint>
+// ============================================================================
+// A list coded as its difference from a reference list, e.g. the previous
+// version of the same list. Only the symmetric difference is stored, as one
+// stream of events in value order:
+//
+//   removal:  kind bit, number of kept reference matches since the previous
+//             event (an index gap, cheap when the reference is dense)
+//   addition: kind bit, gap from the value of the previous event
+//
+// gaps coded as in gap_codec (bit length, then the bits below the leading
+// one). The kind bit is left out once either kind is used up. Applying a
+// delta merges the reference and the events in one pass, straight into the
+// output; the reference is passed decoded, whatever codec stores it.
+//
+// A fingerprint of the reference catches deltas applied to the wrong list.
+//
+// Layout:
+//   varint universe
+//   varint reference_count
+//   varint reference fingerprint
+//   varint removal_count
+//   varint addition_count
+//   arithmetic code: (removal_count + addition_count) events
+class delta_codec
+{
+public:
+    // Universe = number of possible values, at most MAX_UNIVERSE
+    explicit delta_codec(uint64_t universe = NUM_VALUES);
+
+    size_t max_delta_size(uint32_t reference_count, uint32_t match_count) const;
+    // Match count of the list the delta produces
+    size_t applied_size(span<uint8_t const> delta);
+
+    // Both lists sorted, as for the codecs. Returns the delta size
+    size_t delta_into(span<uint32_t const> reference
+        , span<uint32_t const> matches
+        , span<uint8_t> delta);
+    // Returns the number of matches written. Throws if `delta` was made
+    // against another reference or `matches` is too small
+    size_t apply_into(span<uint32_t const> reference
+        , span<uint8_t const> delta
+        , span<uint32_t> matches);
+
+    buffer_t delta(match_list_t const& reference, match_list_t const& matches);
+    match_list_t apply(match_list_t const& reference, span<uint8_t const> delta);
+
+private:
+    uint64_t universe;
+
+    // Long-lived coder state, reused across calls. Both work directly on the
+    // caller's buffers.
+    arithmetic_codec encoder;
+    arithmetic_codec decoder;
+    adaptive_bit_model kind_model;
+    adaptive_data_model removal_model;
+    adaptive_data_model addition_model;
+};
+// ============================================================================
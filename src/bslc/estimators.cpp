@@ -0,0 +1,168 @@
+#include <bslc/estimators.hpp>
+
+#include <bslc/bit_set.hpp>
+#include <bslc/gap_coding.hpp>
+#include <bslc/match_list.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+// ============================================================================
+// count * log2(total / count), the share of `count` equal symbols
+static double entropy_term(double count, double total)
+{
+    return (count > 0.0) ? count * std::log2(total / count) : 0.0;
+}
+// ----------------------------------------------------------------------------
+// LSD radix sort, 11 bit digits: three passes over 32 bits with 2048 entry
+// count tables, O(n) unlike a comparison sort. Passes above the largest
+// value are skipped
+static void radix_sort(std::vector<uint32_t>& values)
+{
+    uint32_t const DIGIT_BITS(11);
+    uint32_t const DIGIT_SIZE(1U << DIGIT_BITS);
+
+    uint32_t largest(0);
+    for (uint32_t v : values) {
+        largest = std::max(largest, v);
+    }
+
+    std::vector<uint32_t> buffer(values.size());
+    std::vector<size_t> offsets(DIGIT_SIZE);
+    for (uint32_t shift(0); (shift < 32) && ((largest >> shift) != 0); shift += DIGIT_BITS) {
+        std::fill(offsets.begin(), offsets.end(), 0);
+        for (uint32_t v : values) {
+            ++offsets[(v >> shift) & (DIGIT_SIZE - 1)];
+        }
+        size_t sum(0);
+        for (size_t& offset : offsets) {
+            size_t const count(offset);
+            offset = sum;
+            sum += count;
+        }
+        for (uint32_t v : values) {
+            buffer[offsets[(v >> shift) & (DIGIT_SIZE - 1)]++] = v;
+        }
+        values.swap(buffer);
+    }
+}
+// ============================================================================
+double subset_bits(uint64_t universe, uint64_t match_count)
+{
+    if ((match_count == 0) || (match_count >= universe)) {
+        return 0.0;
+    }
+    double const n(static_cast<double>(universe));
+    double const k(static_cast<double>(match_count));
+    return (std::lgamma(n + 1.0) - std::lgamma(k + 1.0) - std::lgamma(n - k + 1.0)) / std::log(2.0);
+}
+// ----------------------------------------------------------------------------
+double gap_entropy_bits(span<uint32_t const> matches)
+{
+    if (matches.empty()) {
+        return 0.0;
+    }
+
+    // Gaps minus one, so the first one (from -1) fits 32 bits as well
+    std::vector<uint32_t> gaps(matches.size());
+    gaps[0] = matches[0];
+    for (size_t i(1); i < matches.size(); ++i) {
+        gaps[i] = matches[i] - matches[i - 1] - 1;
+    }
+    radix_sort(gaps);
+
+    double const total(static_cast<double>(gaps.size()));
+    double bits(0.0);
+    size_t first(0);
+    while (first < gaps.size()) {
+        size_t last(first + 1);
+        while ((last < gaps.size()) && (gaps[last] == gaps[first])) {
+            ++last;
+        }
+        bits += entropy_term(double(last - first), total);
+        first = last;
+    }
+    return bits;
+}
+// ----------------------------------------------------------------------------
+double gap_class_bits(span<uint32_t const> matches)
+{
+    uint64_t counts[65] = {};
+    double mantissa_bits(0.0);
+    // As gap_codec: gaps from the smallest value the match could take
+    uint64_t next(0);
+    for (uint32_t match : matches) {
+        uint64_t const gap(match - next);
+        uint32_t const width(bit_width(gap));
+        ++counts[width];
+        mantissa_bits += gap_mantissa_bits(width);
+        next = uint64_t(match) + 1;
+    }
+
+    double const total(static_cast<double>(matches.size()));
+    double bits(mantissa_bits);
+    for (uint64_t count : counts) {
+        bits += entropy_term(double(count), total);
+    }
+    return bits;
+}
+// ----------------------------------------------------------------------------
+double bitmap_entropy_bits(span<uint32_t const> matches, uint64_t universe, uint32_t order)
+{
+    if (order > MAX_BITMAP_ORDER) {
+        throw std::runtime_error("Bitmap context order too large.");
+    }
+    check_universe(universe);
+    check_matches(matches, universe);
+
+    // counts[2 * context + bit], the context is the previous `order` bits
+    // (zeros before the start). Inside a run of zeros the context is all
+    // zeros after `order` steps, the rest of the run is added in one go,
+    // so the work is O(matches * order) rather than O(universe)
+    uint32_t const mask((1U << order) - 1);
+    std::vector<uint64_t> counts(size_t(2) << order);
+    uint32_t context(0);
+
+    auto add_zeros = [&](uint64_t run) {
+        uint64_t const stepped(std::min<uint64_t>(run, order));
+        for (uint64_t i(0); i < stepped; ++i) {
+            ++counts[2 * context];
+            context = (context << 1) & mask;
+        }
+        if (run > stepped) {
+            counts[0] += run - stepped;
+        }
+    };
+
+    uint64_t next(0);
+    for (uint32_t match : matches) {
+        add_zeros(match - next);
+        ++counts[2 * context + 1];
+        context = ((context << 1) | 1) & mask;
+        next = uint64_t(match) + 1;
+    }
+    add_zeros(universe - next);
+
+    double bits(0.0);
+    for (size_t c(0); c < counts.size(); c += 2) {
+        double const zeros(static_cast<double>(counts[c]));
+        double const ones(static_cast<double>(counts[c + 1]));
+        bits += entropy_term(zeros, zeros + ones) + entropy_term(ones, zeros + ones);
+    }
+    return bits;
+}
+// ----------------------------------------------------------------------------
+compressibility estimate_compressibility(span<uint32_t const> matches
+    , uint64_t universe
+    , uint32_t order)
+{
+    compressibility result;
+    result.subset_bits = subset_bits(universe, matches.size());
+    result.gap_entropy_bits = gap_entropy_bits(matches);
+    result.gap_class_bits = gap_class_bits(matches);
+    result.bitmap_order0_bits = bitmap_entropy_bits(matches, universe, 0);
+    result.bitmap_order_bits = bitmap_entropy_bits(matches, universe, order);
+    return result;
+}
+// ============================================================================
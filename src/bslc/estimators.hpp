@@ -0,0 +1,44 @@
+#pragma once
+// ============================================================================
+#include <bslc/span.hpp>
+
+#include <cstdint>
+// ============================================================================
+// Compressibility of a match list, in bits, without compressing it.
+//
+// All of them run in O(match_count) whatever the universe (plus small fixed
+// size tables), cheap enough to call per list when choosing a codec.
+// ============================================================================
+// Largest bitmap context order bitmap_entropy_bits takes
+static uint32_t const MAX_BITMAP_ORDER(16);
+// ----------------------------------------------------------------------------
+// log2 C(universe, match_count) in O(1): the size of the best code for a
+// subset of that size when all of them are equally likely
+double subset_bits(uint64_t universe, uint64_t match_count);
+
+// Empirical order-0 entropy of the gaps (first match counted from -1), times
+// the number of gaps. The table of distinct gaps isn't counted
+double gap_entropy_bits(span<uint32_t const> matches);
+
+// Gaps coded as their bit width (empirical entropy) plus the bits below the
+// leading one verbatim, the way gap_codec does
+double gap_class_bits(span<uint32_t const> matches);
+
+// Empirical entropy of the `universe` bit bitmap, each bit conditioned on
+// the `order` bits before it (0 = order-0), order <= MAX_BITMAP_ORDER
+double bitmap_entropy_bits(span<uint32_t const> matches, uint64_t universe, uint32_t order);
+// ----------------------------------------------------------------------------
+struct compressibility
+{
+    double subset_bits;
+    double gap_entropy_bits;
+    double gap_class_bits;
+    double bitmap_order0_bits;
+    double bitmap_order_bits;
+};
+
+// All of the above at once, the bitmap at order 0 and at `order`
+compressibility estimate_compressibility(span<uint32_t const> matches
+    , uint64_t universe
+    , uint32_t order = 2);
+// ============================================================================
@@ -0,0 +1,169 @@
+#include <bslc/gap_codec.hpp>
+
+#include <bslc/gap_coding.hpp>
+#include <bslc/varint.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+// ============================================================================
+// FastAC limits code buffers to 16 MB
+static size_t const MAX_CODE_BYTES(0x1000000);
+// Gap bit lengths 0 ... 64
+static uint32_t const LENGTH_SYMBOLS(65);
+// ============================================================================
+// Largest value of the universe (0 stands for 2^64)
+static uint64_t last_value(uint64_t universe)
+{
+    return universe - 1;
+}
+// ============================================================================
+gap_codec::gap_codec(uint64_t universe)
+    : universe(universe)
+    , length_model(LENGTH_SYMBOLS)
+{
+}
+// ============================================================================
+size_t gap_codec::max_compressed_size(uint32_t match_count) const
+{
+    // Adaptive model symbols cost at most 15 bits, mantissas at most 63 bits
+    return varint_size(universe) + varint_size(match_count) + size_t(match_count) * 10 + 16;
+}
+// ----------------------------------------------------------------------------
+size_t gap_codec::decompressed_size(span<uint8_t const> compressed)
+{
+    size_t offset(0);
+    get_varint(compressed, offset);
+    return static_cast<size_t>(get_varint(compressed, offset));
+}
+// ============================================================================
+size_t gap_codec::compress_into(span<uint32_t const> matches, span<uint8_t> compressed)
+{
+    return encode_gaps(matches, compressed);
+}
+// ----------------------------------------------------------------------------
+size_t gap_codec::decompress_into(span<uint8_t const> compressed, span<uint32_t> matches)
+{
+    return decode_gaps(compressed, matches);
+}
+// ----------------------------------------------------------------------------
+size_t gap_codec::compress_into(span<uint64_t const> matches, span<uint8_t> compressed)
+{
+    return encode_gaps(matches, compressed);
+}
+// ----------------------------------------------------------------------------
+size_t gap_codec::decompress_into(span<uint8_t const> compressed, span<uint64_t> matches)
+{
+    return decode_gaps(compressed, matches);
+}
+// ============================================================================
+buffer_t gap_codec::compress(match_list64_t const& matches)
+{
+    buffer_t compressed(max_compressed_size(static_cast<uint32_t>(matches.size())));
+    compressed.resize(compress_into(span<uint64_t const>(matches), compressed));
+    return compressed;
+}
+// ----------------------------------------------------------------------------
+void gap_codec::decompress(span<uint8_t const> compressed, match_list64_t& matches)
+{
+    matches.resize(decompressed_size(compressed));
+    decompress_into(compressed, span<uint64_t>(matches));
+}
+// ============================================================================
+template <typename T>
+size_t gap_codec::encode_gaps(span<T const> matches, span<uint8_t> compressed)
+{
+    if (!matches.empty() && (uint64_t(matches.back()) > last_value(universe))) {
+        throw std::runtime_error("Match out of range.");
+    }
+
+    size_t offset(0);
+    put_varint(compressed, offset, universe);
+    put_varint(compressed, offset, matches.size());
+    if (matches.empty()) {
+        return offset;
+    }
+
+    // Code straight into the output, the encoder throws when it runs out
+    size_t const code_bytes(std::min(compressed.size() - offset, MAX_CODE_BYTES));
+    if (code_bytes < 3) {
+        throw std::runtime_error("Output buffer too small.");
+    }
+    encoder.set_buffer(static_cast<uint32_t>(code_bytes), compressed.data() + offset);
+    encoder.start_encoder();
+    length_model.reset();
+
+    // `next` is the smallest value the following match may take
+    uint64_t next(0);
+    for (size_t i(0); i < matches.size(); ++i) {
+        uint64_t const match(matches[i]);
+        // `next` wraps to 0 past the largest 64 bit value
+        if ((i > 0) && ((match < next) || (next == 0))) {
+            encoder.stop_encoder();
+            throw std::runtime_error("Matches must be increasing.");
+        }
+
+        uint64_t const gap(match - next);
+        encode_gap(encoder, length_model, gap);
+        next = match + 1;
+    }
+
+    size_t size(encoder.stop_encoder());
+    // Decoder always starts by reading 3 bytes
+    for (; size < 3; ++size) {
+        compressed[offset + size] = 0;
+    }
+    return offset + size;
+}
+// ----------------------------------------------------------------------------
+template <typename T>
+size_t gap_codec::decode_gaps(span<uint8_t const> compressed, span<T> matches)
+{
+    size_t offset(0);
+    uint64_t const list_universe(get_varint(compressed, offset));
+    uint64_t const match_count(get_varint(compressed, offset));
+    if ((list_universe != 0) && (match_count > list_universe)) {
+        throw std::runtime_error("Invalid match count.");
+    }
+    if (match_count > matches.size()) {
+        throw std::runtime_error("Match buffer too small.");
+    }
+    if (match_count == 0) {
+        return 0;
+    }
+
+    size_t const code_bytes(std::min(compressed.size() - offset, MAX_CODE_BYTES));
+    if (code_bytes < 3) {
+        throw std::runtime_error("Truncated header.");
+    }
+
+    // Decoder only reads from the buffer
+    decoder.set_buffer(static_cast<uint32_t>(code_bytes)
+        , const_cast<uint8_t*>(compressed.data() + offset));
+    decoder.start_decoder();
+    length_model.reset();
+
+    // Values must also fit the output type
+    uint64_t const last(std::min<uint64_t>(last_value(list_universe)
+        , std::numeric_limits<T>::max()));
+
+    uint64_t next(0);
+    for (uint64_t i(0); i < match_count; ++i) {
+        uint64_t const gap(decode_gap(decoder, length_model));
+        if ((next > last) || (gap > last - next)) {
+            decoder.stop_decoder();
+            throw std::runtime_error("Match out of range.");
+        }
+        uint64_t const match(next + gap);
+        if ((match == last) && (i + 1 < match_count)) {
+            decoder.stop_decoder();
+            throw std::runtime_error("Match out of range.");
+        }
+        matches[i] = static_cast<T>(match);
+        next = match + 1;
+    }
+
+    decoder.stop_decoder();
+    return static_cast<size_t>(match_count);
+}
+// ============================================================================
@@ -0,0 +1,56 @@
+#pragma once
+// ============================================================================
+#include <bslc/codec_base.hpp>
+#include <bslc/match_list.hpp>
+#include <bslc/span.hpp>
+
+#include <fastac/adaptive_data_model.hpp>
+#include <fastac/arithmetic_codec.hpp>
+// ============================================================================
+// Gaps between consecutive matches, so the cost depends on the match count
+// only and the universe may be as large as 2^64. Each gap is coded as its bit
+// length (adaptive model) followed by the bits below the leading one.
+//
+// Layout:
+//   varint universe (0 = 2^64)
+//   varint match_count
+//   arithmetic code: match_count x (gap bit length, gap mantissa)
+class gap_codec
+    : public codec_base<gap_codec>
+{
+public:
+    // Universe = number of possible values, 0 for the full 64 bit range
+    explicit gap_codec(uint64_t universe = NUM_VALUES);
+
+    size_t max_compressed_size(uint32_t match_count) const;
+    size_t decompressed_size(span<uint8_t const> compressed);
+
+    size_t compress_into(span<uint32_t const> matches, span<uint8_t> compressed);
+    size_t decompress_into(span<uint8_t const> compressed, span<uint32_t> matches);
+
+    // 64 bit match lists
+    size_t compress_into(span<uint64_t const> matches, span<uint8_t> compressed);
+    size_t decompress_into(span<uint8_t const> compressed, span<uint64_t> matches);
+
+    buffer_t compress(match_list64_t const& matches);
+    void decompress(span<uint8_t const> compressed, match_list64_t& matches);
+
+    using codec_base<gap_codec>::compress;
+    using codec_base<gap_codec>::decompress;
+
+private:
+    template <typename T>
+    size_t encode_gaps(span<T const> matches, span<uint8_t> compressed);
+    template <typename T>
+    size_t decode_gaps(span<uint8_t const> compressed, span<T> matches);
+
+private:
+    uint64_t universe;
+
+    // Long-lived coder state, reused across calls. Both work directly on the
+    // caller's buffers.
+    arithmetic_codec encoder;
+    arithmetic_codec decoder;
+    adaptive_data_model length_model;
+};
+// ============================================================================
@@ -0,0 +1,49 @@
+#pragma once
+// ============================================================================
+#include <bslc/bit_set.hpp>
+
+#include <fastac/arithmetic_codec.hpp>
+
+#include <cstdint>
+// ============================================================================
+// A gap as the gap codecs code it: its bit length (0 for a gap of 0) with an
+// entropy model, then the bits below the leading one raw, the leading one
+// being implied by the length.
+// ============================================================================
+// Raw bits following a length
+inline uint32_t gap_mantissa_bits(uint32_t length)
+{
+    return (length > 1) ? length - 1 : 0;
+}
+// ----------------------------------------------------------------------------
+inline void encode_gap_mantissa(arithmetic_codec& encoder, uint64_t gap, uint32_t length)
+{
+    if (length > 1) {
+        encoder.put_wide_bits(gap & ~(uint64_t(1) << (length - 1)), length - 1);
+    }
+}
+// ----------------------------------------------------------------------------
+// The gap of a decoded length
+inline uint64_t decode_gap_mantissa(arithmetic_codec& decoder, uint32_t length)
+{
+    if (length > 1) {
+        return (uint64_t(1) << (length - 1)) | decoder.get_wide_bits(length - 1);
+    }
+    return length;
+}
+// ----------------------------------------------------------------------------
+// Length and mantissa, the length with any FastAC data model
+template <typename Model>
+inline void encode_gap(arithmetic_codec& encoder, Model& model, uint64_t gap)
+{
+    uint32_t const length(bit_width(gap));
+    encoder.encode(length, model);
+    encode_gap_mantissa(encoder, gap, length);
+}
+// ----------------------------------------------------------------------------
+template <typename Model>
+inline uint64_t decode_gap(arithmetic_codec& decoder, Model& model)
+{
+    return decode_gap_mantissa(decoder, decoder.decode(model));
+}
+// ============================================================================
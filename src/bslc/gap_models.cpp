@@ -0,0 +1,171 @@
+#include <bslc/gap_models.hpp>
+
+#include <bslc/bit_set.hpp>
+#include <bslc/match_list.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+// ============================================================================
+// Fields are stored in host order, every platform we build on is little endian
+static char const MODELS_MAGIC[8] = { 'B', 'S', 'L', 'G', 'A', 'P', 'M', 'D' };
+static uint32_t const MODELS_VERSION(2);
+// Weights of a model add up to about this (plus one per rare symbol)
+static uint64_t const WEIGHT_TOTAL(1 << 12);
+// ============================================================================
+uint32_t gap_density_class(uint64_t universe, uint64_t match_count)
+{
+    return (match_count == 0) ? 0 : bit_width(universe / match_count);
+}
+// ============================================================================
+// Counts scaled to WEIGHT_TOTAL, each at least 1
+static void append_weights(std::vector<uint64_t> const& counts, std::vector<uint16_t>& weights)
+{
+    uint64_t total(0);
+    for (uint64_t count : counts) {
+        total += count;
+    }
+    for (uint64_t count : counts) {
+        uint64_t const weight((count * WEIGHT_TOTAL + total / 2) / total);
+        weights.push_back(static_cast<uint16_t>(std::max<uint64_t>(weight, 1)));
+    }
+}
+// ----------------------------------------------------------------------------
+static static_data_model* load_model(uint16_t const* weights, uint32_t symbols, std::string const& path)
+{
+    double total(0.0);
+    for (uint32_t s(0); s < symbols; ++s) {
+        total += weights[s];
+    }
+    std::vector<double> probability(symbols);
+    for (uint32_t s(0); s < symbols; ++s) {
+        probability[s] = weights[s] / total;
+        // static_data_model takes 0.0001 ... 0.9999
+        if ((weights[s] == 0) || (probability[s] < 0.0001) || (probability[s] > 0.9999)) {
+            throw std::runtime_error("Malformed gap model file: " + path);
+        }
+    }
+    return new static_data_model(symbols, probability.data());
+}
+// ============================================================================
+gap_model_trainer::gap_model_trainer(uint64_t universe)
+    : list_universe(universe)
+    , counts(GAP_DENSITY_CLASSES, std::vector<uint64_t>(GAP_LENGTH_SYMBOLS))
+    , count_counts(GAP_COUNT_SYMBOLS)
+    , list_count(0)
+{
+    check_universe(universe);
+}
+// ----------------------------------------------------------------------------
+void gap_model_trainer::add(span<uint32_t const> matches)
+{
+    check_matches(matches, list_universe);
+    ++count_counts[bit_width(matches.size())];
+    ++list_count;
+    if (matches.empty()) {
+        return;
+    }
+
+    std::vector<uint64_t>& lengths(counts[gap_density_class(list_universe, matches.size())]);
+    uint64_t next(0);
+    for (uint32_t match : matches) {
+        ++lengths[bit_width(match - next)];
+        next = uint64_t(match) + 1;
+    }
+}
+// ----------------------------------------------------------------------------
+void gap_model_trainer::write(std::string const& path, uint32_t id) const
+{
+    std::vector<bool> trained(GAP_DENSITY_CLASSES);
+    bool any(false);
+    for (uint32_t c(0); c < GAP_DENSITY_CLASSES; ++c) {
+        trained[c] = std::any_of(counts[c].begin(), counts[c].end(), [](uint64_t count) {
+            return count != 0;
+        });
+        any = any || trained[c];
+    }
+    if (!any) {
+        throw std::runtime_error("No lists to train gap models on.");
+    }
+
+    std::vector<uint16_t> weights;
+    weights.reserve(GAP_DENSITY_CLASSES * GAP_LENGTH_SYMBOLS + GAP_COUNT_SYMBOLS);
+    for (uint32_t c(0); c < GAP_DENSITY_CLASSES; ++c) {
+        // Nearest trained class, the lower one on a tie
+        uint32_t source(c);
+        for (uint32_t d(1); !trained[source]; ++d) {
+            if ((c >= d) && trained[c - d]) {
+                source = c - d;
+            } else if ((c + d < GAP_DENSITY_CLASSES) && trained[c + d]) {
+                source = c + d;
+            }
+        }
+        append_weights(counts[source], weights);
+    }
+    append_weights(count_counts, weights);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        throw std::runtime_error("Unable to create " + path);
+    }
+
+    uint32_t const version[2] = { MODELS_VERSION, id };
+    uint32_t const sizes[3] = { GAP_DENSITY_CLASSES, GAP_LENGTH_SYMBOLS, GAP_COUNT_SYMBOLS };
+    file.write(MODELS_MAGIC, sizeof(MODELS_MAGIC));
+    file.write(reinterpret_cast<char const*>(version), sizeof(version));
+    file.write(reinterpret_cast<char const*>(&list_universe), sizeof(list_universe));
+    file.write(reinterpret_cast<char const*>(sizes), sizeof(sizes));
+    file.write(reinterpret_cast<char const*>(weights.data())
+        , static_cast<std::streamsize>(weights.size() * sizeof(uint16_t)));
+    if (!file.flush()) {
+        throw std::runtime_error("Unable to write " + path);
+    }
+}
+// ============================================================================
+gap_models::gap_models(std::string const& path)
+    : model_id(0)
+    , model_universe(0)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Unable to open " + path);
+    }
+
+    char magic[8];
+    uint32_t version[2];
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(version), sizeof(version));
+    if (!file || (std::memcmp(magic, MODELS_MAGIC, sizeof(magic)) != 0)) {
+        throw std::runtime_error("Not a gap model file: " + path);
+    }
+    if (version[0] != MODELS_VERSION) {
+        throw std::runtime_error("Unsupported gap model version in " + path);
+    }
+    model_id = version[1];
+
+    uint32_t sizes[3];
+    file.read(reinterpret_cast<char*>(&model_universe), sizeof(model_universe));
+    file.read(reinterpret_cast<char*>(sizes), sizeof(sizes));
+    if (!file) {
+        throw std::runtime_error("Truncated gap model file: " + path);
+    }
+    if ((model_universe == 0) || (model_universe > MAX_UNIVERSE)
+        || (sizes[0] != GAP_DENSITY_CLASSES) || (sizes[1] != GAP_LENGTH_SYMBOLS)
+        || (sizes[2] != GAP_COUNT_SYMBOLS)) {
+        throw std::runtime_error("Malformed gap model file: " + path);
+    }
+
+    std::vector<uint16_t> weights(GAP_DENSITY_CLASSES * GAP_LENGTH_SYMBOLS + GAP_COUNT_SYMBOLS);
+    file.read(reinterpret_cast<char*>(weights.data())
+        , static_cast<std::streamsize>(weights.size() * sizeof(uint16_t)));
+    if (!file) {
+        throw std::runtime_error("Truncated gap model file: " + path);
+    }
+
+    for (uint32_t c(0); c < GAP_DENSITY_CLASSES; ++c) {
+        models.emplace_back(load_model(weights.data() + c * GAP_LENGTH_SYMBOLS, GAP_LENGTH_SYMBOLS, path));
+    }
+    counts.reset(load_model(weights.data() + GAP_DENSITY_CLASSES * GAP_LENGTH_SYMBOLS, GAP_COUNT_SYMBOLS, path));
+}
+// ============================================================================
@@ -0,0 +1,117 @@
+#pragma once
+// ============================================================================
+#include <bslc/span.hpp>
+
+#include <fastac/static_data_model.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+// ============================================================================
+// Trained gap length distributions, one static_data_model per density class,
+// so short lists can be coded without a header of their own or a model that
+// still has to learn. Train once over a corpus of one universe, load the file
+// at startup and share it between codecs; streams name the file by its ID.
+//
+// The density class of a list is the bit width of universe / match_count
+// (its mean gap), the symbols are gap bit lengths 0 ... 32 as in gap_codec.
+// Match counts are coded the same way, their bit lengths 0 ... 33 with one
+// more trained model.
+//
+// Layout (little endian):
+//   char[8]  magic "BSLGAPMD"
+//   uint32   version (2)
+//   uint32   id
+//   uint64   universe
+//   uint32   class_count (34)
+//   uint32   length_count (33)
+//   uint32   count_length_count (34)
+//   class_count x length_count uint16 gap length weights, all >= 1
+//   count_length_count uint16 count length weights, all >= 1
+// ============================================================================
+static uint32_t const GAP_DENSITY_CLASSES(34);
+static uint32_t const GAP_LENGTH_SYMBOLS(33);
+static uint32_t const GAP_COUNT_SYMBOLS(34);
+// ----------------------------------------------------------------------------
+uint32_t gap_density_class(uint64_t universe, uint64_t match_count);
+// ============================================================================
+class gap_model_trainer
+{
+public:
+    // Universe = number of possible values of every list, at most
+    // MAX_UNIVERSE
+    explicit gap_model_trainer(uint64_t universe);
+
+    uint64_t universe() const;
+
+    void add(span<uint32_t const> matches);
+    // Classes without lists borrow the nearest trained class. Throws on I/O
+    // errors or when nothing was added
+    void write(std::string const& path, uint32_t id) const;
+
+    size_t size() const;
+
+private:
+    uint64_t list_universe;
+    // counts[density class][gap length]
+    std::vector<std::vector<uint64_t>> counts;
+    // count_counts[match count length]
+    std::vector<uint64_t> count_counts;
+    size_t list_count;
+};
+// ----------------------------------------------------------------------------
+class gap_models
+{
+public:
+    // Throws if the file is missing, malformed or of another version
+    explicit gap_models(std::string const& path);
+
+    gap_models(gap_models const&) = delete;
+    gap_models& operator=(gap_models const&) = delete;
+
+    uint32_t id() const;
+    // Of the lists the models were trained on
+    uint64_t universe() const;
+    // The models are never changed by coding, codecs on several threads may
+    // share them
+    static_data_model& model(uint32_t density_class) const;
+    static_data_model& count_model() const;
+
+private:
+    uint32_t model_id;
+    uint64_t model_universe;
+    std::vector<std::unique_ptr<static_data_model>> models;
+    std::unique_ptr<static_data_model> counts;
+};
+// ============================================================================
+inline uint64_t gap_model_trainer::universe() const
+{
+    return list_universe;
+}
+// ----------------------------------------------------------------------------
+inline size_t gap_model_trainer::size() const
+{
+    return list_count;
+}
+// ----------------------------------------------------------------------------
+inline uint32_t gap_models::id() const
+{
+    return model_id;
+}
+// ----------------------------------------------------------------------------
+inline uint64_t gap_models::universe() const
+{
+    return model_universe;
+}
+// ----------------------------------------------------------------------------
+inline static_data_model& gap_models::model(uint32_t density_class) const
+{
+    return *models[density_class];
+}
+// ----------------------------------------------------------------------------
+inline static_data_model& gap_models::count_model() const
+{
+    return *counts;
+}
+// ============================================================================
@@ -0,0 +1,204 @@
+#include <bslc/histogram.hpp>
+
+// hist.h has no C++ guard of its own
+extern "C" {
+#include <fse/hist.h>
+}
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+// ============================================================================
+// Bytes always have their table
+static size_t const BYTE_SYMBOLS(256);
+static size_t const WORD_SYMBOLS(65536);
+// Below this many 16 bit symbols a 512 KiB table costs more than hashing
+static size_t const MIN_DENSE_WORDS(1 << 14);
+// HIST_count_wksp counts in unsigned
+static size_t const MAX_HIST_CHUNK(size_t(1) << 30);
+static size_t const MIN_SLOTS(64);
+// ----------------------------------------------------------------------------
+static size_t hash_slot(uint64_t value, uint32_t shift)
+{
+    return static_cast<size_t>((value * 0x9E3779B97F4A7C15ULL) >> shift);
+}
+// ============================================================================
+histogram::histogram()
+    : dense(BYTE_SYMBOLS)
+    , slots_used(0)
+    , hash_shift(64)
+    , symbol_count(0)
+{
+}
+// ----------------------------------------------------------------------------
+void histogram::clear()
+{
+    dense.assign(BYTE_SYMBOLS, 0);
+    slots.clear();
+    slots_used = 0;
+    hash_shift = 64;
+    symbol_count = 0;
+}
+// ============================================================================
+void histogram::count(span<uint8_t const> data)
+{
+    unsigned counts[BYTE_SYMBOLS];
+    unsigned workspace[HIST_WKSP_SIZE_U32];
+
+    for (size_t first(0); first < data.size(); first += MAX_HIST_CHUNK) {
+        size_t const size(std::min(data.size() - first, MAX_HIST_CHUNK));
+        unsigned max_symbol(BYTE_SYMBOLS - 1);
+        size_t const result(HIST_count_wksp(counts, &max_symbol, data.data() + first, size, workspace));
+        if (HIST_isError(result)) {
+            throw std::runtime_error("Histogram error.");
+        }
+        for (unsigned symbol(0); symbol <= max_symbol; ++symbol) {
+            dense[symbol] += counts[symbol];
+        }
+    }
+    symbol_count += data.size();
+}
+// ----------------------------------------------------------------------------
+void histogram::count(span<uint16_t const> data)
+{
+    if (data.size() < MIN_DENSE_WORDS) {
+        for (uint16_t value : data) {
+            add(value, 1);
+        }
+    } else {
+        grow_dense(WORD_SYMBOLS);
+        uint64_t* const table(dense.data());
+        for (uint16_t value : data) {
+            ++table[value];
+        }
+    }
+    symbol_count += data.size();
+}
+// ----------------------------------------------------------------------------
+void histogram::count(span<uint32_t const> data)
+{
+    for (uint32_t value : data) {
+        add(value, 1);
+    }
+    symbol_count += data.size();
+}
+// ----------------------------------------------------------------------------
+void histogram::count(span<uint64_t const> data)
+{
+    for (uint64_t value : data) {
+        add(value, 1);
+    }
+    symbol_count += data.size();
+}
+// ============================================================================
+size_t histogram::distinct() const
+{
+    size_t result(slots_used);
+    for (uint64_t count : dense) {
+        result += (count != 0) ? 1 : 0;
+    }
+    return result;
+}
+// ----------------------------------------------------------------------------
+double histogram::entropy() const
+{
+    if (symbol_count == 0) {
+        return 0.0;
+    }
+
+    double const total(static_cast<double>(symbol_count));
+    double bits(0.0);
+    auto add_term = [&](uint64_t count) {
+        if (count != 0) {
+            double const c(static_cast<double>(count));
+            bits += c * std::log2(total / c);
+        }
+    };
+    for (uint64_t count : dense) {
+        add_term(count);
+    }
+    for (slot const& s : slots) {
+        add_term(s.count);
+    }
+    return bits / total;
+}
+// ============================================================================
+void histogram::add(uint64_t value, uint64_t count)
+{
+    if (value < dense.size()) {
+        dense[static_cast<size_t>(value)] += count;
+    } else {
+        add_hashed(value, count);
+    }
+}
+// ----------------------------------------------------------------------------
+void histogram::add_hashed(uint64_t value, uint64_t count)
+{
+    // At most half full
+    if (2 * (slots_used + 1) > slots.size()) {
+        std::vector<slot> old;
+        old.swap(slots);
+        size_t const size(std::max(MIN_SLOTS, 2 * old.size()));
+        slots.assign(size, slot{ 0, 0 });
+        hash_shift = 64;
+        for (size_t s(size); s > 1; s >>= 1) {
+            --hash_shift;
+        }
+        slots_used = 0;
+        for (slot const& s : old) {
+            if (s.count != 0) {
+                add_hashed(s.value, s.count);
+            }
+        }
+    }
+
+    size_t const mask(slots.size() - 1);
+    for (size_t i(hash_slot(value, hash_shift)); ; i = (i + 1) & mask) {
+        slot& s(slots[i]);
+        if (s.count == 0) {
+            s.value = value;
+            s.count = count;
+            ++slots_used;
+            return;
+        }
+        if (s.value == value) {
+            s.count += count;
+            return;
+        }
+    }
+}
+// ----------------------------------------------------------------------------
+void histogram::grow_dense(size_t size)
+{
+    if (size <= dense.size()) {
+        return;
+    }
+    dense.resize(size, 0);
+
+    // Hashed values the table covers now move into it
+    std::vector<slot> old;
+    old.swap(slots);
+    slots_used = 0;
+    hash_shift = 64;
+    for (slot const& s : old) {
+        if (s.count != 0) {
+            add(s.value, s.count);
+        }
+    }
+}
+// ----------------------------------------------------------------------------
+std::vector<histogram::slot> histogram::sorted_slots() const
+{
+    std::vector<slot> result;
+    result.reserve(slots_used);
+    for (slot const& s : slots) {
+        if (s.count != 0) {
+            result.push_back(s);
+        }
+    }
+    std::sort(result.begin(), result.end(), [](slot const& a, slot const& b) {
+        return a.value < b.value;
+    });
+    return result;
+}
+// ============================================================================
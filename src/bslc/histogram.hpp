@@ -0,0 +1,88 @@
+#pragma once
+// ============================================================================
+#include <bslc/span.hpp>
+
+#include <cstdint>
+#include <vector>
+// ============================================================================
+// Symbol counts of a buffer, for model building and entropy analysis.
+//
+// Bytes are counted by HIST_count_wksp (four interleaved tables, so
+// repeated symbols don't serialize on one counter), 16 bit symbols in a
+// dense table and anything wider in an open addressing hash table. Values
+// below the dense table size always go to the table, whatever the type
+// they came in as, so the counts of several calls add up.
+class histogram
+{
+public:
+    histogram();
+
+    void clear();
+
+    void count(span<uint8_t const> data);
+    void count(span<uint16_t const> data);
+    void count(span<uint32_t const> data);
+    void count(span<uint64_t const> data);
+    // Other integer types, through the hashed path
+    template <typename T>
+    void count(span<T const> data);
+
+    uint64_t total() const;
+    // Number of distinct symbols seen
+    size_t distinct() const;
+    // Order-0 entropy in bits per symbol, 0 when empty
+    double entropy() const;
+
+    // f(value, count) for every symbol seen, by ascending value (as uint64_t)
+    template <typename F>
+    void for_each(F const& f) const;
+
+private:
+    struct slot
+    {
+        uint64_t value;
+        uint64_t count; // 0 = free
+    };
+
+    void add(uint64_t value, uint64_t count);
+    void add_hashed(uint64_t value, uint64_t count);
+    void grow_dense(size_t size);
+    std::vector<slot> sorted_slots() const;
+
+private:
+    std::vector<uint64_t> dense;
+    // Power of two sized, indexed by the top bits of a multiplicative hash
+    std::vector<slot> slots;
+    size_t slots_used;
+    uint32_t hash_shift;
+    uint64_t symbol_count;
+};
+// ============================================================================
+inline uint64_t histogram::total() const
+{
+    return symbol_count;
+}
+// ----------------------------------------------------------------------------
+template <typename T>
+void histogram::count(span<T const> data)
+{
+    for (T value : data) {
+        add(static_cast<uint64_t>(value), 1);
+    }
+    symbol_count += data.size();
+}
+// ----------------------------------------------------------------------------
+template <typename F>
+void histogram::for_each(F const& f) const
+{
+    for (size_t value(0); value < dense.size(); ++value) {
+        if (dense[value] != 0) {
+            f(uint64_t(value), dense[value]);
+        }
+    }
+    // Hashed values are all above the dense ones
+    for (slot const& s : sorted_slots()) {
+        f(s.value, s.count);
+    }
+}
+// ============================================================================
@@ -0,0 +1,221 @@
+#include <bslc/interleaved_codec.hpp>
+
+#include <bslc/bitmap_coding.hpp>
+#include <bslc/lane_coder.hpp>
+#include <bslc/size_bounds.hpp>
+#include <bslc/varint.hpp>
+
+#include <fastac/static_bit_model.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+// ============================================================================
+interleaved_codec::interleaved_codec(uint32_t lane_count, uint64_t universe)
+    : lane_count(lane_count)
+    , universe(universe)
+    , lane_capacity(0)
+{
+    if ((lane_count != 2) && (lane_count != 4) && (lane_count != 8)) {
+        throw std::runtime_error("Lane count must be 2, 4 or 8.");
+    }
+    check_universe(universe);
+}
+// ============================================================================
+size_t interleaved_codec::max_compressed_size(uint32_t match_count) const
+{
+    // Every lane codes a share of the same static model, plus its own flush
+    // bytes, padding and size varint
+    uint64_t const positions((universe + lane_count - 1) / lane_count * lane_count);
+    double const probability_0(bitmap_probability_0(match_count, universe));
+    return varint_size(universe) + varint_size(match_count) + 1
+        + static_bit_model_bound(positions, match_count, probability_0) + size_t(lane_count) * 12;
+}
+// ----------------------------------------------------------------------------
+size_t interleaved_codec::decompressed_size(span<uint8_t const> compressed)
+{
+    size_t offset(0);
+    get_varint(compressed, offset);
+    return static_cast<size_t>(get_varint(compressed, offset));
+}
+// ----------------------------------------------------------------------------
+size_t interleaved_codec::lane_bound(uint32_t match_count) const
+{
+    // A lane sees every lane_count-th position and any share of the matches.
+    // The cost is linear in its match count, so one of the extremes is worst
+    uint64_t const positions((universe + lane_count - 1) / lane_count);
+    uint64_t const most_matches(std::min<uint64_t>(match_count, positions));
+    double const probability_0(bitmap_probability_0(match_count, universe));
+    return std::max(static_bit_model_bound(positions, 0, probability_0)
+        , static_bit_model_bound(positions, most_matches, probability_0)) + 64;
+}
+// ============================================================================
+size_t interleaved_codec::compress_into(span<uint32_t const> matches, span<uint8_t> compressed)
+{
+    check_matches(matches, universe);
+
+    size_t offset(0);
+    put_varint(compressed, offset, universe);
+    put_varint(compressed, offset, matches.size());
+    if (matches.empty()) {
+        return offset;
+    }
+
+    lane_capacity = lane_bound(static_cast<uint32_t>(matches.size()));
+    if (code_buffer.size() < lane_capacity * lane_count) {
+        code_buffer.resize(lane_capacity * lane_count);
+    }
+
+    uint32_t lane_sizes[8];
+    switch (lane_count) {
+    case 2: encode_lanes<2>(matches, lane_sizes); break;
+    case 4: encode_lanes<4>(matches, lane_sizes); break;
+    case 8: encode_lanes<8>(matches, lane_sizes); break;
+    }
+
+    if (offset >= compressed.size()) {
+        throw std::runtime_error("Output buffer too small.");
+    }
+    compressed[offset++] = static_cast<uint8_t>(lane_count);
+    for (uint32_t i(0); i + 1 < lane_count; ++i) {
+        put_varint(compressed, offset, lane_sizes[i]);
+    }
+    for (uint32_t i(0); i < lane_count; ++i) {
+        if (offset + lane_sizes[i] > compressed.size()) {
+            throw std::runtime_error("Output buffer too small.");
+        }
+        std::memcpy(compressed.data() + offset, &code_buffer[i * lane_capacity], lane_sizes[i]);
+        offset += lane_sizes[i];
+    }
+
+    return offset;
+}
+// ----------------------------------------------------------------------------
+template <uint32_t LANES>
+void interleaved_codec::encode_lanes(span<uint32_t const> matches, uint32_t sizes[])
+{
+    static_bit_model model;
+    model.set_probability_0(bitmap_probability_0(matches.size(), universe));
+    uint32_t const bit_0_prob(model.scaled_probability_0());
+
+    uint8_t* lane_data[LANES];
+    for (uint32_t l(0); l < LANES; ++l) {
+        lane_data[l] = &code_buffer[l * lane_capacity];
+    }
+
+    lane_bit_encoder<LANES> encoder;
+    encoder.start_encoder(lane_data, static_cast<uint32_t>(lane_capacity));
+
+    // Code whole rounds until the round holding the last match
+    uint32_t const* match(matches.begin());
+    for (uint64_t i(0); match != matches.end(); i += LANES) {
+        uint32_t bits[LANES];
+        for (uint32_t l(0); l < LANES; ++l) {
+            bits[l] = (match != matches.end()) && (*match == i + l);
+            match += bits[l];
+        }
+        encoder.encode(bits, bit_0_prob);
+    }
+
+    encoder.stop_encoder(sizes);
+}
+// ============================================================================
+size_t interleaved_codec::decompress_into(span<uint8_t const> compressed, span<uint32_t> matches)
+{
+    size_t offset(0);
+    uint64_t const list_universe(get_varint(compressed, offset));
+    check_universe(list_universe);
+    uint64_t match_count(get_varint(compressed, offset));
+    if (match_count > list_universe) {
+        throw std::runtime_error("Invalid match count.");
+    }
+
+    if (match_count > matches.size()) {
+        throw std::runtime_error("Match buffer too small.");
+    }
+    if (match_count == 0) {
+        return 0;
+    }
+
+    if ((offset >= compressed.size()) || (compressed[offset] != lane_count)) {
+        throw std::runtime_error("Lane count mismatch.");
+    }
+    ++offset;
+
+    uint32_t lane_sizes[8];
+    size_t lane_total(0);
+    for (uint32_t i(0); i + 1 < lane_count; ++i) {
+        lane_sizes[i] = static_cast<uint32_t>(get_varint(compressed, offset));
+        lane_total += lane_sizes[i];
+    }
+    if (offset + lane_total > compressed.size()) {
+        throw std::runtime_error("Truncated lane data.");
+    }
+    lane_sizes[lane_count - 1] = static_cast<uint32_t>(compressed.size() - offset - lane_total);
+
+    uint8_t const* lane_data[8];
+    for (uint32_t i(0); i < lane_count; ++i) {
+        if (lane_sizes[i] < 4) {
+            throw std::runtime_error("Invalid lane size.");
+        }
+        lane_data[i] = compressed.data() + offset;
+        offset += lane_sizes[i];
+    }
+
+    uint32_t count(static_cast<uint32_t>(match_count));
+    switch (lane_count) {
+    case 2: decode_lanes<2>(lane_data, lane_sizes, list_universe, count, matches.data()); break;
+    case 4: decode_lanes<4>(lane_data, lane_sizes, list_universe, count, matches.data()); break;
+    case 8: decode_lanes<8>(lane_data, lane_sizes, list_universe, count, matches.data()); break;
+    }
+    return count;
+}
+// ----------------------------------------------------------------------------
+template <uint32_t LANES>
+void interleaved_codec::decode_lanes(uint8_t const* const lane_data[]
+    , uint32_t const sizes[]
+    , uint64_t list_universe
+    , uint32_t match_count
+    , uint32_t* output)
+{
+    static_bit_model model;
+    model.set_probability_0(bitmap_probability_0(match_count, list_universe));
+    uint32_t const bit_0_prob(model.scaled_probability_0());
+
+    lane_bit_decoder<LANES> decoder;
+    decoder.start_decoder(lane_data, sizes);
+
+    uint32_t found(0);
+    uint64_t i(0);
+
+    // While a whole round fits in the output and the universe, store every
+    // position and only advance past the matches (no branches on the decoded
+    // bits)
+    for (; (match_count - found >= LANES) && (i + LANES <= list_universe); i += LANES) {
+        // Same schedule as the encoder: one bit from every lane per round
+        uint32_t bits[LANES];
+        decoder.decode(bits, bit_0_prob);
+        for (uint32_t l(0); l < LANES; ++l) {
+            output[found] = static_cast<uint32_t>(i + l);
+            found += bits[l];
+        }
+    }
+
+    // Last few matches, checked one by one to stay inside the output
+    for (; found < match_count; i += LANES) {
+        if (i >= list_universe) {
+            throw std::runtime_error("Corrupted lane data.");
+        }
+        uint32_t bits[LANES];
+        decoder.decode(bits, bit_0_prob);
+        for (uint32_t l(0); (l < LANES) && (found < match_count); ++l) {
+            if (bits[l]) {
+                if (i + l >= list_universe) {
+                    throw std::runtime_error("Corrupted lane data.");
+                }
+                output[found++] = static_cast<uint32_t>(i + l);
+            }
+        }
+    }
+}
+// ============================================================================
@@ -0,0 +1,53 @@
+#pragma once
+// ============================================================================
+#include <bslc/codec_base.hpp>
+#include <bslc/match_list.hpp>
+#include <bslc/span.hpp>
+
+#include <vector>
+// ============================================================================
+// Bitmap coded with a static bit model (as in v1) by 2, 4 or 8 independent
+// coder states taking turns: position i is coded by lane (i % lane_count).
+// The lanes have no data dependencies on each other, so their arithmetic
+// overlaps in the CPU pipeline, both when encoding and decoding.
+//
+// Layout:
+//   varint universe
+//   varint match_count
+//   byte lane_count
+//   (lane_count - 1) x varint lane byte_count (last lane takes the rest)
+//   lane data, back to back
+class interleaved_codec
+    : public codec_base<interleaved_codec>
+{
+public:
+    explicit interleaved_codec(uint32_t lane_count = 4, uint64_t universe = NUM_VALUES);
+
+    size_t max_compressed_size(uint32_t match_count) const;
+    size_t decompressed_size(span<uint8_t const> compressed);
+
+    size_t compress_into(span<uint32_t const> matches, span<uint8_t> compressed);
+    size_t decompress_into(span<uint8_t const> compressed, span<uint32_t> matches);
+
+private:
+    template <uint32_t LANES>
+    void encode_lanes(span<uint32_t const> matches, uint32_t sizes[]);
+    template <uint32_t LANES>
+    void decode_lanes(uint8_t const* const lane_data[]
+        , uint32_t const sizes[]
+        , uint64_t list_universe
+        , uint32_t match_count
+        , uint32_t* output);
+
+    // Worst case bytes of one lane
+    size_t lane_bound(uint32_t match_count) const;
+
+private:
+    uint32_t lane_count;
+    uint64_t universe;
+
+    // One code buffer, lane i owns the region [i * lane_capacity, (i + 1) * lane_capacity)
+    size_t lane_capacity;
+    buffer_t code_buffer;
+};
+// ============================================================================
@@ -0,0 +1,212 @@
+#pragma once
+// ============================================================================
+#include <fastac/constants.hpp>
+
+#include <cstdint>
+#include <stdexcept>
+// ============================================================================
+// Several FastAC binary coder states advanced in lock step.
+//
+// Each lane is the static bit model path of arithmetic_codec, inlined so that
+// the independent dependency chains of the lanes can overlap. Every lane
+// produces a plain FastAC stream, decodable by arithmetic_codec on its own.
+// ============================================================================
+template <uint32_t LANES>
+class lane_bit_encoder
+{
+public:
+    // Lane l writes to buffers[l], at most `capacity` bytes
+    void start_encoder(uint8_t* const buffers[], uint32_t capacity);
+    // Codes bits[l] in lane l, `bit_0_prob` as in static_bit_model
+    void encode(uint32_t const bits[], uint32_t bit_0_prob);
+    // Stores number of bytes used by lane l in sizes[l], at least the 4 the
+    // decoder starts with
+    void stop_encoder(uint32_t sizes[]);
+
+private:
+    void propagate_carry(uint32_t lane);
+    void renorm_enc_interval(uint32_t lane, uint32_t& lane_base, uint32_t& lane_length);
+
+private:
+    uint32_t base[LANES];
+    uint32_t length[LANES];
+    uint8_t* code_buffer[LANES];
+    uint8_t* ac_pointer[LANES];
+    uint8_t* code_end[LANES];
+};
+// ----------------------------------------------------------------------------
+template <uint32_t LANES>
+class lane_bit_decoder
+{
+public:
+    // Lane l reads sizes[l] bytes from buffers[l], zeros past the end
+    void start_decoder(uint8_t const* const buffers[], uint32_t const sizes[]);
+    // Decodes one bit from every lane into bits[l]
+    void decode(uint32_t bits[], uint32_t bit_0_prob);
+
+private:
+    void renorm_dec_interval(uint32_t lane, uint32_t& lane_value, uint32_t& lane_length);
+
+private:
+    uint32_t value[LANES];
+    uint32_t length[LANES];
+    uint8_t const* ac_pointer[LANES];
+    uint8_t const* code_end[LANES];
+};
+// ============================================================================
+template <uint32_t LANES>
+inline void lane_bit_encoder<LANES>::start_encoder(uint8_t* const buffers[], uint32_t capacity)
+{
+    for (uint32_t l(0); l < LANES; ++l) {
+        base[l] = 0;
+        length[l] = AC__MaxLength;
+        code_buffer[l] = ac_pointer[l] = buffers[l];
+        code_end[l] = buffers[l] + capacity;
+    }
+}
+// ----------------------------------------------------------------------------
+template <uint32_t LANES>
+inline void lane_bit_encoder<LANES>::encode(uint32_t const bits[], uint32_t bit_0_prob)
+{
+    uint32_t const length_shift(BM__LengthShift);
+    uint32_t const min_length(AC__MinLength);
+
+    for (uint32_t l(0); l < LANES; ++l) {
+        // work on locals, byte stores could alias the member arrays
+        uint32_t lane_base(base[l]);
+        uint32_t lane_length(length[l]);
+
+        uint32_t x = bit_0_prob * (lane_length >> length_shift); // product l x p0
+
+        // branch-free interval update
+        uint32_t mask = 0U - (bits[l] != 0);
+        lane_base += x & mask;
+        lane_length = (x & ~mask) | ((lane_length - x) & mask);
+
+        if (lane_base < base[l]) {
+            propagate_carry(l); // overflow = carry
+        }
+        if (lane_length < min_length) {
+            renorm_enc_interval(l, lane_base, lane_length);
+        }
+
+        base[l] = lane_base;
+        length[l] = lane_length;
+    }
+}
+// ----------------------------------------------------------------------------
+template <uint32_t LANES>
+inline void lane_bit_encoder<LANES>::stop_encoder(uint32_t sizes[])
+{
+    for (uint32_t l(0); l < LANES; ++l) {
+        // same termination as arithmetic_codec::stop_encoder
+        uint32_t init_base = base[l];
+        if (length[l] > 2 * AC__MinLength) {
+            base[l] += AC__MinLength;
+            length[l] = AC__MinLength >> 1;
+        } else {
+            base[l] += AC__MinLength >> 1;
+            length[l] = AC__MinLength >> 9;
+        }
+        if (init_base > base[l]) {
+            propagate_carry(l);
+        }
+        renorm_enc_interval(l, base[l], length[l]);
+
+        // Zeros, as the decoder reads past the end, so the output depends
+        // on nothing but the input
+        while (ac_pointer[l] - code_buffer[l] < 4) {
+            if (ac_pointer[l] >= code_end[l]) {
+                throw std::runtime_error("Code buffer overflow.");
+            }
+            *ac_pointer[l]++ = 0;
+        }
+        sizes[l] = static_cast<uint32_t>(ac_pointer[l] - code_buffer[l]);
+    }
+}
+// ----------------------------------------------------------------------------
+template <uint32_t LANES>
+inline void lane_bit_encoder<LANES>::propagate_carry(uint32_t lane)
+{
+    // Only rewrites bytes already out, a carry cannot reach past the first
+    uint8_t* p;
+    for (p = ac_pointer[lane] - 1; *p == 0xFFU; p--) {
+        *p = 0;
+    }
+    ++*p;
+}
+// ----------------------------------------------------------------------------
+template <uint32_t LANES>
+inline void lane_bit_encoder<LANES>::renorm_enc_interval(uint32_t lane
+    , uint32_t& lane_base
+    , uint32_t& lane_length)
+{
+    uint8_t* p(ac_pointer[lane]);
+    do {
+        if (p >= code_end[lane]) {
+            throw std::runtime_error("Code buffer overflow.");
+        }
+        *p++ = static_cast<uint8_t>(lane_base >> 24);
+        lane_base <<= 8;
+    } while ((lane_length <<= 8) < AC__MinLength);
+    ac_pointer[lane] = p;
+}
+// ============================================================================
+template <uint32_t LANES>
+inline void lane_bit_decoder<LANES>::start_decoder(uint8_t const* const buffers[]
+    , uint32_t const sizes[])
+{
+    for (uint32_t l(0); l < LANES; ++l) {
+        length[l] = AC__MaxLength;
+        code_end[l] = buffers[l] + sizes[l];
+        ac_pointer[l] = buffers[l] + 3;
+        value[l] = 0;
+        for (uint32_t i(0); i < 4; ++i) {
+            uint32_t byte = (i < sizes[l]) ? static_cast<uint32_t>(buffers[l][i]) : 0;
+            value[l] = (value[l] << 8) | byte;
+        }
+    }
+}
+// ----------------------------------------------------------------------------
+template <uint32_t LANES>
+inline void lane_bit_decoder<LANES>::decode(uint32_t bits[], uint32_t bit_0_prob)
+{
+    uint32_t const length_shift(BM__LengthShift);
+    uint32_t const min_length(AC__MinLength);
+
+    for (uint32_t l(0); l < LANES; ++l) {
+        uint32_t lane_value(value[l]);
+        uint32_t lane_length(length[l]);
+
+        uint32_t x = bit_0_prob * (lane_length >> length_shift); // product l x p0
+        uint32_t bit = (lane_value >= x); // decision
+
+        // branch-free interval update
+        uint32_t mask = 0U - bit;
+        lane_value -= x & mask;
+        lane_length = (x & ~mask) | ((lane_length - x) & mask);
+
+        if (lane_length < min_length) {
+            renorm_dec_interval(l, lane_value, lane_length);
+        }
+
+        value[l] = lane_value;
+        length[l] = lane_length;
+        bits[l] = bit;
+    }
+}
+// ----------------------------------------------------------------------------
+template <uint32_t LANES>
+inline void lane_bit_decoder<LANES>::renorm_dec_interval(uint32_t lane
+    , uint32_t& lane_value
+    , uint32_t& lane_length)
+{
+    uint8_t const* p(ac_pointer[lane]);
+    do {
+        ++p;
+        uint32_t byte = (p < code_end[lane]) ? static_cast<uint32_t>(*p) : 0;
+        lane_value = (lane_value << 8) | byte;
+    } while ((lane_length <<= 8) < AC__MinLength);
+    ac_pointer[lane] = p;
+}
+// ============================================================================
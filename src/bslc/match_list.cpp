@@ -0,0 +1,219 @@
+#include <bslc/match_list.hpp>
+
+#include <bslc/bit_set.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+// ============================================================================
+void check_universe(uint64_t universe)
+{
+    if ((universe == 0) || (universe > MAX_UNIVERSE)) {
+        throw std::runtime_error("Invalid universe.");
+    }
+}
+// ----------------------------------------------------------------------------
+void check_matches(span<uint32_t const> matches, uint64_t universe)
+{
+    if (!matches.empty() && (matches.back() >= universe)) {
+        throw std::runtime_error("Match out of range.");
+    }
+}
+// ----------------------------------------------------------------------------
+size_t symbol_count(uint8_t bits, uint64_t universe)
+{
+    size_t count(static_cast<size_t>(universe / bits));
+    if (universe % bits > 0) {
+        return count + 1;
+    }
+    return count;
+}
+// ----------------------------------------------------------------------------
+void set_symbol(match_symbols_t& symbols, uint8_t bits, uint32_t match, bool state)
+{
+    size_t index(match / bits);
+    size_t offset(match % bits);
+    if (state) {
+        symbols[index] |= 1 << offset;
+    } else {
+        symbols[index] &= ~(1 << offset);
+    }
+}
+// ----------------------------------------------------------------------------
+bool get_symbol(match_symbols_t const& symbols, uint8_t bits, uint32_t match)
+{
+    size_t index(match / bits);
+    size_t offset(match % bits);
+    return (symbols[index] & (1 << offset)) != 0;
+}
+// ============================================================================
+// Symbol bitmap kernels. `BITS` values per byte, so eight bytes form a word of
+// which only the low `BITS` bits of every byte are used. Bytes are loaded as
+// little endian words.
+template <uint32_t BITS>
+static uint64_t symbol_mask()
+{
+    return 0x0101010101010101ULL * ((1U << BITS) - 1);
+}
+// ----------------------------------------------------------------------------
+static inline uint64_t load_word(uint8_t const* data, size_t size)
+{
+    uint64_t word(0);
+    if (size >= 8) {
+        std::memcpy(&word, data, 8);
+    } else {
+        std::memcpy(&word, data, size);
+    }
+    return word;
+}
+// ----------------------------------------------------------------------------
+static inline void or_word(uint8_t* data, size_t size, uint64_t word)
+{
+    word |= load_word(data, size);
+    if (size >= 8) {
+        std::memcpy(data, &word, 8);
+    } else {
+        std::memcpy(data, &word, size);
+    }
+}
+// ----------------------------------------------------------------------------
+template <uint32_t BITS>
+static size_t scatter_symbols(span<uint32_t const> matches
+    , size_t first_symbol
+    , span<uint8_t> symbols)
+{
+    uint64_t const first_value(uint64_t(first_symbol) * BITS);
+    uint64_t const last_value(first_value + uint64_t(symbols.size()) * BITS);
+
+    size_t const match_count(matches.size());
+    size_t count(0);
+    while ((count < match_count) && (matches[count] < last_value)) {
+        size_t offset(static_cast<size_t>(matches[count] - first_value));
+        size_t symbol(offset / BITS);
+        size_t const index(symbol & ~size_t(7));
+
+        // Collect all the matches falling into the same 8 byte word
+        uint64_t word(0);
+        do {
+            word |= uint64_t(1) << ((symbol & 7) * 8 + (offset - symbol * BITS));
+            if ((++count == match_count) || (matches[count] >= last_value)) {
+                break;
+            }
+            offset = static_cast<size_t>(matches[count] - first_value);
+            symbol = offset / BITS;
+        } while ((symbol & ~size_t(7)) == index);
+
+        or_word(symbols.data() + index, symbols.size() - index, word);
+    }
+    return count;
+}
+// ----------------------------------------------------------------------------
+template <uint32_t BITS>
+static size_t gather_symbols(span<uint8_t const> symbols
+    , size_t first_symbol
+    , span<uint32_t> matches
+    , size_t count)
+{
+    uint64_t const mask(symbol_mask<BITS>());
+    uint32_t* output(matches.data() + count);
+    uint32_t* const end(matches.data() + matches.size());
+
+    for (size_t i(0); i < symbols.size(); i += 8) {
+        uint64_t word(load_word(symbols.data() + i, symbols.size() - i) & mask);
+        // Most words of a sparse bitmap are empty
+        if (word == 0) {
+            continue;
+        }
+        if (uint32_t(end - output) < population_count(word)) {
+            throw std::runtime_error("Match buffer too small.");
+        }
+
+        uint32_t const base(static_cast<uint32_t>((first_symbol + i) * BITS));
+        if (BITS == 8) {
+            output = extract_bits(word, base, output);
+        } else {
+            do {
+                uint32_t const bit(count_trailing_zeros(word));
+                *output++ = base + (bit >> 3) * BITS + (bit & 7);
+                word &= word - 1;
+            } while (word != 0);
+        }
+    }
+    return static_cast<size_t>(output - matches.data());
+}
+// ============================================================================
+match_symbols_t make_symbols(match_list_t const& matches, uint8_t bits)
+{
+    match_symbols_t symbols;
+    make_symbols(matches, bits, symbols);
+    return symbols;
+}
+// ----------------------------------------------------------------------------
+void make_symbols(span<uint32_t const> matches, uint8_t bits, match_symbols_t& symbols)
+{
+    symbols.resize(symbol_count(bits));
+    if (make_symbols(matches, bits, 0, symbols) != matches.size()) {
+        throw std::runtime_error("Match out of range.");
+    }
+}
+// ----------------------------------------------------------------------------
+match_list_t make_matches(match_symbols_t const& symbols, uint8_t bits)
+{
+    uint64_t const mask(0x0101010101010101ULL * ((1U << bits) - 1));
+    size_t total(0);
+    for (size_t i(0); i < symbols.size(); i += 8) {
+        total += population_count(load_word(symbols.data() + i, symbols.size() - i) & mask);
+    }
+
+    match_list_t result(total);
+    make_matches(symbols, bits, result);
+    return result;
+}
+// ----------------------------------------------------------------------------
+size_t make_matches(match_symbols_t const& symbols, uint8_t bits, span<uint32_t> matches)
+{
+    return make_matches(symbols, bits, 0, matches, 0);
+}
+// ============================================================================
+size_t make_symbols(span<uint32_t const> matches
+    , uint8_t bits
+    , size_t first_symbol
+    , span<uint8_t> symbols)
+{
+    assert((bits > 0) && (bits <= 8));
+
+    std::fill(symbols.begin(), symbols.end(), uint8_t(0));
+
+    switch (bits) {
+    case 1: return scatter_symbols<1>(matches, first_symbol, symbols);
+    case 2: return scatter_symbols<2>(matches, first_symbol, symbols);
+    case 3: return scatter_symbols<3>(matches, first_symbol, symbols);
+    case 4: return scatter_symbols<4>(matches, first_symbol, symbols);
+    case 5: return scatter_symbols<5>(matches, first_symbol, symbols);
+    case 6: return scatter_symbols<6>(matches, first_symbol, symbols);
+    case 7: return scatter_symbols<7>(matches, first_symbol, symbols);
+    default: return scatter_symbols<8>(matches, first_symbol, symbols);
+    }
+}
+// ----------------------------------------------------------------------------
+size_t make_matches(span<uint8_t const> symbols
+    , uint8_t bits
+    , size_t first_symbol
+    , span<uint32_t> matches
+    , size_t count)
+{
+    assert((bits > 0) && (bits <= 8));
+
+    switch (bits) {
+    case 1: return gather_symbols<1>(symbols, first_symbol, matches, count);
+    case 2: return gather_symbols<2>(symbols, first_symbol, matches, count);
+    case 3: return gather_symbols<3>(symbols, first_symbol, matches, count);
+    case 4: return gather_symbols<4>(symbols, first_symbol, matches, count);
+    case 5: return gather_symbols<5>(symbols, first_symbol, matches, count);
+    case 6: return gather_symbols<6>(symbols, first_symbol, matches, count);
+    case 7: return gather_symbols<7>(symbols, first_symbol, matches, count);
+    default: return gather_symbols<8>(symbols, first_symbol, matches, count);
+    }
+}
+// ============================================================================
@@ -0,0 +1,53 @@
+#pragma once
+// ============================================================================
+#include <bslc/span.hpp>
+
+#include <cstdint>
+#include <set>
+#include <vector>
+// ============================================================================
+typedef std::vector<uint8_t> match_symbols_t;
+typedef std::vector<uint32_t> match_list_t;
+typedef std::vector<uint64_t> match_list64_t;
+typedef std::set<uint32_t> match_set_t;
+typedef std::vector<uint8_t> buffer_t;
+// ----------------------------------------------------------------------------
+static uint32_t const NUM_VALUES(1000000);
+// Largest universe of 32 bit match lists
+static uint64_t const MAX_UNIVERSE(uint64_t(1) << 32);
+// Bitmap slice the streaming codecs work on, small enough to stay in L2
+static size_t const BITMAP_CHUNK_SIZE(32 * 1024);
+// ============================================================================
+// Throws unless 1 <= universe <= MAX_UNIVERSE
+void check_universe(uint64_t universe);
+// Throws if the (sorted) matches don't fit in the universe
+void check_matches(span<uint32_t const> matches, uint64_t universe);
+
+size_t symbol_count(uint8_t bits, uint64_t universe = NUM_VALUES);
+
+void set_symbol(match_symbols_t& symbols, uint8_t bits, uint32_t match, bool state);
+bool get_symbol(match_symbols_t const& symbols, uint8_t bits, uint32_t match);
+
+match_symbols_t make_symbols(match_list_t const& matches, uint8_t bits);
+// Reuses the storage of `symbols`
+void make_symbols(span<uint32_t const> matches, uint8_t bits, match_symbols_t& symbols);
+
+match_list_t make_matches(match_symbols_t const& symbols, uint8_t bits);
+// Returns number of matches written, throws if they don't fit
+size_t make_matches(match_symbols_t const& symbols, uint8_t bits, span<uint32_t> matches);
+
+// Bitmap chunks: `symbols` holds the symbols starting at symbol `first_symbol`.
+// Fills the chunk from the front of `matches` (those below the chunk must be
+// consumed already), returns how many matches fell into it
+size_t make_symbols(span<uint32_t const> matches
+    , uint8_t bits
+    , size_t first_symbol
+    , span<uint8_t> symbols);
+// Stores the matches of the chunk at `matches[count]` onwards, returns the
+// new count. Throws if they don't fit
+size_t make_matches(span<uint8_t const> symbols
+    , uint8_t bits
+    , size_t first_symbol
+    , span<uint32_t> matches
+    , size_t count);
+// ============================================================================
@@ -0,0 +1,309 @@
+#include <bslc/mixing_codec.hpp>
+
+#include <bslc/bit_set.hpp>
+#include <bslc/bitmap_coding.hpp>
+#include <bslc/size_bounds.hpp>
+#include <bslc/varint.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+// ============================================================================
+// FastAC limits code buffers to 16 MB
+static size_t const MAX_CODE_BYTES(0x1000000);
+
+static uint8_t const MODE_MIXED(0);
+static uint8_t const MODE_STATIC(1);
+
+static uint32_t const ORDER_BITS(12);
+// Distances below this have a context each, longer ones one per bit width
+static uint32_t const EXACT_DISTANCES(256);
+// Bit widths of distances up to 2^32
+static uint32_t const DISTANCE_WIDTHS(34);
+static uint32_t const RUN_BITS(6);
+static uint32_t const MIXER_INPUTS(5);
+// Stretch domain: ln(p / (1 - p)) * 256
+static int32_t const MAX_STRETCH(4095);
+// Counters adapt as 1 / hits up to this many, then stay at that rate
+static uint32_t const COUNTER_LIMIT(255);
+static uint32_t const LEARNING_RATE(6);
+// Mixer weights in 16.16 fixed point, kept within +-32 so that long runs
+// of one bit cannot push them past int32_t
+static int32_t const MAX_WEIGHT(32 << 16);
+// ============================================================================
+// 65536 / (1 + exp(-x / 256)) at x = -4096, -3968, ..., 4096
+static int32_t const SQUASH_POINTS[65] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 2, 3, 5, 8, 13
+    , 22, 36, 60, 98, 162, 267, 439, 720, 1179, 1921, 3108, 4971, 7812, 11955, 17625, 24743
+    , 32768, 40793, 47911, 53581, 57724, 60565, 62428, 63615, 64357, 64816, 65097, 65269, 65374, 65438, 65476, 65500
+    , 65514, 65523, 65528, 65531, 65533, 65534, 65535, 65535, 65536, 65536, 65536, 65536, 65536, 65536, 65536, 65536
+    , 65536
+};
+// ----------------------------------------------------------------------------
+// Probability of a one in 16 bits, 1 .. 65535, of a stretched value
+static uint32_t squash(int32_t x)
+{
+    x = std::max(-MAX_STRETCH, std::min(MAX_STRETCH, x)) + 4096;
+    int32_t const i(x >> 7);
+    int32_t const w(x & 127);
+    int32_t const p((SQUASH_POINTS[i] * (128 - w) + SQUASH_POINTS[i + 1] * w + 64) >> 7);
+    return static_cast<uint32_t>(std::max(1, std::min(65535, p)));
+}
+// ----------------------------------------------------------------------------
+// Inverse of squash, indexed by the top 12 bits of a 16 bit probability
+struct stretch_table
+{
+    stretch_table()
+    {
+        int32_t next(0);
+        for (int32_t x(-MAX_STRETCH); x <= MAX_STRETCH; ++x) {
+            int32_t const p(static_cast<int32_t>(squash(x) >> 4));
+            for (; next <= p; ++next) {
+                values[next] = static_cast<int16_t>(x);
+            }
+        }
+        for (; next < 4096; ++next) {
+            values[next] = static_cast<int16_t>(MAX_STRETCH);
+        }
+    }
+
+    int16_t values[4096];
+};
+// ----------------------------------------------------------------------------
+static int32_t stretch(uint32_t probability)
+{
+    static stretch_table const table;
+    return table.values[probability >> 4];
+}
+// ----------------------------------------------------------------------------
+// Counter updates scale the error by 1 / (hits + 1.5): (error / 8) x
+// 16384 / (2 hits + 3), added at bit 10 of the counter
+struct rate_table
+{
+    rate_table()
+    {
+        for (uint32_t n(0); n < 1024; ++n) {
+            values[n] = static_cast<int32_t>(16384 / (n + n + 3));
+        }
+    }
+
+    int32_t values[1024];
+};
+// ----------------------------------------------------------------------------
+static uint32_t counter_probability(uint32_t counter)
+{
+    return counter >> 16;
+}
+// ----------------------------------------------------------------------------
+static void update_counter(uint32_t& counter, uint32_t bit)
+{
+    static rate_table const rates;
+
+    uint32_t const hits(counter & 1023);
+    int64_t const probability(counter >> 10);
+    if (hits < COUNTER_LIMIT) {
+        ++counter;
+    } else {
+        counter = (counter & 0xFFFFFC00U) | COUNTER_LIMIT;
+    }
+    int64_t const delta(((int64_t(bit) << 22) - probability) >> 3);
+    counter += static_cast<uint32_t>(delta * rates.values[hits]) & 0xFFFFFC00U;
+}
+// ============================================================================
+mixing_codec::mixing_codec(uint64_t universe)
+    : universe(universe)
+    , order_counters(size_t(1) << ORDER_BITS)
+    , distance_counters(EXACT_DISTANCES + DISTANCE_WIDTHS)
+    , position_counters(64 * 4)
+    , run_counters(DISTANCE_WIDTHS << RUN_BITS)
+    , weights(DISTANCE_WIDTHS * MIXER_INPUTS)
+    , history(0)
+    , distance(0)
+    , mixer(nullptr)
+    , mixed(0)
+{
+    check_universe(universe);
+}
+// ============================================================================
+size_t mixing_codec::max_compressed_size(uint32_t match_count) const
+{
+    // Mixed code is only kept when it fits the static bound
+    return varint_size(universe) + 1 + 9 + static_bit_model_bound(universe, match_count);
+}
+// ----------------------------------------------------------------------------
+size_t mixing_codec::decompressed_size(span<uint8_t const> compressed)
+{
+    uint64_t list_universe(0);
+    uint8_t mode(0);
+    uint64_t match_count(start_decoder(compressed, list_universe, mode));
+    decoder.stop_decoder();
+    return static_cast<size_t>(match_count);
+}
+// ============================================================================
+size_t mixing_codec::compress_into(span<uint32_t const> matches, span<uint8_t> compressed)
+{
+    check_matches(matches, universe);
+
+    size_t offset(0);
+    put_varint(compressed, offset, universe);
+    if (offset >= compressed.size()) {
+        throw std::runtime_error("Output buffer too small.");
+    }
+    size_t const mode_offset(offset++);
+
+    // Code straight into the output, the encoder throws when it runs out
+    size_t const code_bytes(std::min(compressed.size() - offset, MAX_CODE_BYTES));
+    if (code_bytes < 3) {
+        throw std::runtime_error("Output buffer too small.");
+    }
+    size_t const mixed_bytes(std::min(code_bytes, 9 + static_bit_model_bound(universe, matches.size())));
+
+    size_t size(0);
+    try {
+        encoder.set_buffer(static_cast<uint32_t>(mixed_bytes), compressed.data() + offset);
+        encoder.start_encoder();
+        encode_mixed(matches);
+        size = encoder.stop_encoder();
+        compressed[mode_offset] = MODE_MIXED;
+    } catch (std::runtime_error const&) {
+        // Beyond the static bound, the encoder can be restarted
+        encoder.set_buffer(static_cast<uint32_t>(code_bytes), compressed.data() + offset);
+        encoder.start_encoder();
+        encode_static_bitmap(encoder, matches, universe);
+        size = encoder.stop_encoder();
+        compressed[mode_offset] = MODE_STATIC;
+    }
+
+    // Decoder always starts by reading 3 bytes
+    for (; size < 3; ++size) {
+        compressed[offset + size] = 0;
+    }
+    return offset + size;
+}
+// ----------------------------------------------------------------------------
+size_t mixing_codec::decompress_into(span<uint8_t const> compressed, span<uint32_t> matches)
+{
+    uint64_t list_universe(0);
+    uint8_t mode(0);
+    uint64_t match_count(start_decoder(compressed, list_universe, mode));
+    if (match_count > matches.size()) {
+        decoder.stop_decoder();
+        throw std::runtime_error("Match buffer too small.");
+    }
+
+    uint64_t found(0);
+    if (mode == MODE_MIXED) {
+        reset_model();
+        for (uint64_t i(0); (i < list_universe) && (found < match_count); ++i) {
+            uint32_t const bit(decoder.decode_bit(predict(i)));
+            update(bit);
+            if (bit == 1) {
+                matches[found++] = static_cast<uint32_t>(i);
+            }
+        }
+    } else {
+        found = decode_static_bitmap(decoder, list_universe, match_count, matches.data());
+    }
+
+    decoder.stop_decoder();
+    if (found != match_count) {
+        throw std::runtime_error("Corrupted data.");
+    }
+    return static_cast<size_t>(match_count);
+}
+// ============================================================================
+void mixing_codec::encode_mixed(span<uint32_t const> matches)
+{
+    encoder.put_wide_bits(matches.size(), bit_width(universe));
+    reset_model();
+
+    // Every bit up to the last match, the decoder stops there too
+    uint64_t position(0);
+    for (uint32_t match : matches) {
+        for (; position < match; ++position) {
+            encoder.encode_bit(0, predict(position));
+            update(0);
+        }
+        encoder.encode_bit(1, predict(position));
+        update(1);
+        ++position;
+    }
+}
+// ============================================================================
+uint64_t mixing_codec::start_decoder(span<uint8_t const> compressed
+    , uint64_t& list_universe
+    , uint8_t& mode)
+{
+    size_t offset(0);
+    list_universe = get_varint(compressed, offset);
+    check_universe(list_universe);
+
+    if (offset >= compressed.size()) {
+        throw std::runtime_error("Truncated header.");
+    }
+    mode = compressed[offset++];
+    if ((mode != MODE_MIXED) && (mode != MODE_STATIC)) {
+        throw std::runtime_error("Invalid coding mode.");
+    }
+
+    return start_bitmap_decoder(decoder, compressed, offset, list_universe);
+}
+// ============================================================================
+void mixing_codec::reset_model()
+{
+    // Counters at 1/2 with no hits, weights sharing the counters evenly
+    uint32_t const half(1U << 31);
+    std::fill(order_counters.begin(), order_counters.end(), half);
+    std::fill(distance_counters.begin(), distance_counters.end(), half);
+    std::fill(position_counters.begin(), position_counters.end(), half);
+    std::fill(run_counters.begin(), run_counters.end(), half);
+    for (size_t i(0); i < weights.size(); ++i) {
+        weights[i] = ((i % MIXER_INPUTS) == MIXER_INPUTS - 1) ? 0 : (1 << 16) / 3;
+    }
+    history = 0;
+    distance = 1;
+}
+// ----------------------------------------------------------------------------
+uint32_t mixing_codec::predict(uint64_t position)
+{
+    uint32_t const width(bit_width(distance));
+    uint32_t const distance_context((distance < EXACT_DISTANCES)
+        ? static_cast<uint32_t>(distance)
+        : EXACT_DISTANCES + width);
+    uint32_t const position_context(static_cast<uint32_t>(((position & 63) << 2)
+        | ((history >> 62) & 2)
+        | (history & 1)));
+
+    counters[0] = &order_counters[history & ((1U << ORDER_BITS) - 1)];
+    counters[1] = &distance_counters[distance_context];
+    counters[2] = &position_counters[position_context];
+    counters[3] = &run_counters[(width << RUN_BITS) | (history & ((1U << RUN_BITS) - 1))];
+    mixer = &weights[width * MIXER_INPUTS];
+
+    int64_t dot(0);
+    for (uint32_t i(0); i < 4; ++i) {
+        inputs[i] = stretch(counter_probability(*counters[i]));
+        dot += int64_t(inputs[i]) * mixer[i];
+    }
+    inputs[4] = 256;
+    dot += int64_t(inputs[4]) * mixer[4];
+
+    mixed = squash(static_cast<int32_t>(std::max<int64_t>(-MAX_STRETCH, std::min<int64_t>(MAX_STRETCH, dot >> 16))));
+    return 65536 - mixed;
+}
+// ----------------------------------------------------------------------------
+void mixing_codec::update(uint32_t bit)
+{
+    // Mixer error in 12 bits, weights move along the inputs
+    int32_t const error((int32_t(bit << 12) - int32_t(mixed >> 4)) * LEARNING_RATE);
+    for (uint32_t i(0); i < MIXER_INPUTS; ++i) {
+        int32_t const weight(mixer[i] + ((inputs[i] * error + 0x8000) >> 16));
+        mixer[i] = std::max(-MAX_WEIGHT, std::min(MAX_WEIGHT, weight));
+    }
+    for (uint32_t i(0); i < 4; ++i) {
+        update_counter(*counters[i], bit);
+    }
+
+    history = (history << 1) | bit;
+    distance = bit ? 1 : distance + 1;
+}
+// ============================================================================
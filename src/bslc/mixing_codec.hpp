@@ -0,0 +1,80 @@
+#pragma once
+// ============================================================================
+#include <bslc/codec_base.hpp>
+#include <bslc/match_list.hpp>
+#include <bslc/span.hpp>
+
+#include <fastac/arithmetic_codec.hpp>
+
+#include <vector>
+// ============================================================================
+// Bitmap coded bit by bit with several adaptive predictions mixed together,
+// for when size matters more than speed (several times slower than v2).
+//
+// Each bit is predicted from the previous 12 bits, the distance since the
+// last one, its position in a 64 bit word (with the bit a word earlier) and
+// the distance bucket with the previous 6 bits. The predictions are mixed in
+// the logistic domain by a small online mixer, one weight set per distance
+// bucket, and the result coded with a 16 bit probability. All the arithmetic
+// is integer, with table driven stretch / squash, so encoder and decoder
+// agree on any platform.
+//
+// Bitmaps the model does worse on than the density alone are coded with a
+// static model instead, so the size never exceeds that bound.
+//
+// Layout:
+//   varint universe
+//   byte mode (0 = mixed, 1 = static)
+//   arithmetic code: match_count (bit width of the universe), bitmap up to
+//   the last match
+class mixing_codec
+    : public codec_base<mixing_codec>
+{
+public:
+    // Universe = number of possible values, at most MAX_UNIVERSE
+    explicit mixing_codec(uint64_t universe = NUM_VALUES);
+
+    size_t max_compressed_size(uint32_t match_count) const;
+    size_t decompressed_size(span<uint8_t const> compressed);
+
+    size_t compress_into(span<uint32_t const> matches, span<uint8_t> compressed);
+    size_t decompress_into(span<uint8_t const> compressed, span<uint32_t> matches);
+
+private:
+    void encode_mixed(span<uint32_t const> matches);
+
+    // Reads the header and starts the decoder, returns the match count
+    uint64_t start_decoder(span<uint8_t const> compressed, uint64_t& list_universe, uint8_t& mode);
+
+    // Model state for the bit at `position`, before it is known
+    void reset_model();
+    uint32_t predict(uint64_t position);
+    void update(uint32_t bit);
+
+private:
+    uint64_t universe;
+
+    // Long-lived coder state, reused across calls. Both work directly on the
+    // caller's buffers.
+    arithmetic_codec encoder;
+    arithmetic_codec decoder;
+
+    // Counters: probability of a one in the top 22 bits, hit count below
+    std::vector<uint32_t> order_counters;
+    std::vector<uint32_t> distance_counters;
+    std::vector<uint32_t> position_counters;
+    std::vector<uint32_t> run_counters;
+    std::vector<int32_t> weights;
+
+    // The last 64 bits, newest in bit 0
+    uint64_t history;
+    // Bits since the last one (position + 1 before the first)
+    uint64_t distance;
+
+    // Set by predict() for update()
+    uint32_t* counters[4];
+    int32_t inputs[5];
+    int32_t* mixer;
+    uint32_t mixed;
+};
+// ============================================================================
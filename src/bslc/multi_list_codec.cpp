@@ -0,0 +1,243 @@
+#include <bslc/multi_list_codec.hpp>
+
+#include <bslc/gap_coding.hpp>
+#include <bslc/gap_models.hpp>
+#include <bslc/varint.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+// ============================================================================
+// FastAC limits code buffers to 16 MB
+static size_t const MAX_CODE_BYTES(0x1000000);
+// Gap bit lengths 0 ... 32, match count bit lengths 0 ... 33
+static uint32_t const LENGTH_SYMBOLS(33);
+static uint32_t const COUNT_SYMBOLS(34);
+// Empty lists cost next to nothing once the count model adapts, so the list
+// count of a stream is bounded through its blocks
+static uint64_t const MAX_LISTS_PER_BLOCK(1 << 16);
+// ============================================================================
+multi_list_codec::multi_list_codec(uint32_t lists_per_block, uint64_t universe)
+    : lists_per_block(lists_per_block)
+    , universe(universe)
+    , count_model(COUNT_SYMBOLS)
+    , length_models(GAP_DENSITY_CLASSES, adaptive_data_model(LENGTH_SYMBOLS))
+    , fresh_count_model(COUNT_SYMBOLS)
+    , fresh_length_model(LENGTH_SYMBOLS)
+    , list_universe(0)
+    , list_block_size(0)
+{
+    check_universe(universe);
+    if ((lists_per_block == 0) || (lists_per_block > MAX_LISTS_PER_BLOCK)) {
+        throw std::runtime_error("Invalid block size.");
+    }
+}
+// ============================================================================
+size_t multi_list_codec::max_compressed_size(span<match_list_t const> lists) const
+{
+    // Adaptive model symbols cost at most 15 bits, mantissas at most 32 bits.
+    // Blocks add a directory entry and at most 16 bytes of termination
+    size_t const block_count((lists.size() + lists_per_block - 1) / lists_per_block);
+    size_t size(varint_size(universe) + varint_size(lists.size()) + varint_size(lists_per_block)
+        + block_count * (10 + 16) + lists.size() * 6);
+    for (match_list_t const& list : lists) {
+        size += list.size() * 6;
+    }
+    return size;
+}
+// ----------------------------------------------------------------------------
+size_t multi_list_codec::list_count(span<uint8_t const> compressed)
+{
+    return static_cast<size_t>(read_header(compressed));
+}
+// ============================================================================
+size_t multi_list_codec::compress_into(span<match_list_t const> lists, span<uint8_t> compressed)
+{
+    for (match_list_t const& list : lists) {
+        check_matches(list, universe);
+    }
+
+    size_t offset(0);
+    put_varint(compressed, offset, universe);
+    put_varint(compressed, offset, lists.size());
+    put_varint(compressed, offset, lists_per_block);
+
+    // Blocks go behind room for the largest directory, then move up to the
+    // directory actually written
+    size_t const block_count((lists.size() + lists_per_block - 1) / lists_per_block);
+    size_t const directory(offset);
+    size_t const first_block(directory + block_count * varint_size(compressed.size()));
+    if (first_block > compressed.size()) {
+        throw std::runtime_error("Output buffer too small.");
+    }
+
+    block_offsets.resize(block_count + 1);
+    block_offsets[0] = first_block;
+    for (size_t b(0); b < block_count; ++b) {
+        // Code straight into the output, the encoder throws when it runs out
+        size_t const start(block_offsets[b]);
+        size_t const code_bytes(std::min(compressed.size() - start, MAX_CODE_BYTES));
+        if (code_bytes < 3) {
+            throw std::runtime_error("Output buffer too small.");
+        }
+        encoder.set_buffer(static_cast<uint32_t>(code_bytes), compressed.data() + start);
+        encoder.start_encoder();
+        reset_models();
+
+        size_t const end(std::min(lists.size(), (b + 1) * lists_per_block));
+        for (size_t i(b * lists_per_block); i < end; ++i) {
+            encode_list(lists[i]);
+        }
+
+        size_t size(encoder.stop_encoder());
+        // Decoder always starts by reading 3 bytes
+        for (; size < 3; ++size) {
+            compressed[start + size] = 0;
+        }
+        block_offsets[b + 1] = start + size;
+    }
+
+    for (size_t b(0); b < block_count; ++b) {
+        put_varint(compressed, offset, block_offsets[b + 1] - block_offsets[b]);
+    }
+    size_t const data_size(block_offsets[block_count] - first_block);
+    if ((offset != first_block) && (data_size != 0)) {
+        std::memmove(compressed.data() + offset, compressed.data() + first_block, data_size);
+    }
+    return offset + data_size;
+}
+// ----------------------------------------------------------------------------
+buffer_t multi_list_codec::compress(span<match_list_t const> lists)
+{
+    buffer_t compressed(max_compressed_size(lists));
+    compressed.resize(compress_into(lists, compressed));
+    return compressed;
+}
+// ============================================================================
+void multi_list_codec::decompress(span<uint8_t const> compressed, std::vector<match_list_t>& lists)
+{
+    lists.resize(static_cast<size_t>(read_header(compressed)));
+
+    size_t const block_count(block_offsets.size() - 1);
+    for (size_t b(0); b < block_count; ++b) {
+        // Decoder only reads from the buffer
+        decoder.set_buffer(static_cast<uint32_t>(block_offsets[b + 1] - block_offsets[b])
+            , const_cast<uint8_t*>(compressed.data() + block_offsets[b]));
+        decoder.start_decoder();
+        reset_models();
+
+        size_t const end(std::min(lists.size(), static_cast<size_t>((b + 1) * list_block_size)));
+        for (size_t i(static_cast<size_t>(b * list_block_size)); i < end; ++i) {
+            decode_list(lists[i]);
+        }
+        decoder.stop_decoder();
+    }
+}
+// ----------------------------------------------------------------------------
+void multi_list_codec::decompress_list(span<uint8_t const> compressed
+    , size_t index
+    , match_list_t& matches)
+{
+    if (index >= read_header(compressed)) {
+        throw std::runtime_error("List index out of range.");
+    }
+
+    size_t const b(static_cast<size_t>(index / list_block_size));
+    decoder.set_buffer(static_cast<uint32_t>(block_offsets[b + 1] - block_offsets[b])
+        , const_cast<uint8_t*>(compressed.data() + block_offsets[b]));
+    decoder.start_decoder();
+    reset_models();
+
+    // The lists before it in the block are decoded to bring the models along
+    for (size_t i(static_cast<size_t>(b * list_block_size)); i < index; ++i) {
+        decode_list(skipped);
+    }
+    decode_list(matches);
+    decoder.stop_decoder();
+}
+// ============================================================================
+uint64_t multi_list_codec::read_header(span<uint8_t const> compressed)
+{
+    size_t offset(0);
+    list_universe = get_varint(compressed, offset);
+    check_universe(list_universe);
+    uint64_t const count(get_varint(compressed, offset));
+    list_block_size = get_varint(compressed, offset);
+    if ((list_block_size == 0) || (list_block_size > MAX_LISTS_PER_BLOCK)) {
+        throw std::runtime_error("Invalid block size.");
+    }
+
+    // Every directory entry takes a byte at least, which bounds the list
+    // count by the stream size before anything is allocated for it
+    uint64_t const block_count(count / list_block_size + ((count % list_block_size) != 0));
+    if (block_count > compressed.size() - offset) {
+        throw std::runtime_error("Truncated directory.");
+    }
+
+    block_offsets.resize(static_cast<size_t>(block_count) + 1);
+    for (size_t b(0); b < block_count; ++b) {
+        uint64_t const size(get_varint(compressed, offset));
+        if ((size < 3) || (size > MAX_CODE_BYTES)) {
+            throw std::runtime_error("Invalid block size.");
+        }
+        block_offsets[b + 1] = static_cast<size_t>(size);
+    }
+    block_offsets[0] = offset;
+    for (size_t b(0); b < block_count; ++b) {
+        block_offsets[b + 1] += block_offsets[b];
+        if (block_offsets[b + 1] > compressed.size()) {
+            throw std::runtime_error("Truncated block.");
+        }
+    }
+    return count;
+}
+// ----------------------------------------------------------------------------
+void multi_list_codec::reset_models()
+{
+    // Copies of the fresh state, the distributions aren't recomputed
+    count_model.restore(fresh_count_model);
+    for (adaptive_data_model& model : length_models) {
+        model.restore(fresh_length_model);
+    }
+}
+// ----------------------------------------------------------------------------
+void multi_list_codec::encode_list(span<uint32_t const> matches)
+{
+    encode_gap(encoder, count_model, matches.size());
+    if (matches.empty()) {
+        return;
+    }
+
+    adaptive_data_model& length_model(length_models[gap_density_class(universe, matches.size())]);
+    uint64_t next(0);
+    for (uint32_t match : matches) {
+        encode_gap(encoder, length_model, match - next);
+        next = uint64_t(match) + 1;
+    }
+}
+// ----------------------------------------------------------------------------
+void multi_list_codec::decode_list(match_list_t& matches)
+{
+    uint64_t const match_count(decode_gap(decoder, count_model));
+    if (match_count > list_universe) {
+        decoder.stop_decoder();
+        throw std::runtime_error("Invalid match count.");
+    }
+    matches.resize(static_cast<size_t>(match_count));
+    if (match_count == 0) {
+        return;
+    }
+
+    adaptive_data_model& length_model(length_models[gap_density_class(list_universe, match_count)]);
+    uint64_t next(0);
+    for (uint32_t& match : matches) {
+        uint64_t const gap(decode_gap(decoder, length_model));
+        if (gap >= list_universe - next) {
+            decoder.stop_decoder();
+            throw std::runtime_error("Match out of range.");
+        }
+        match = static_cast<uint32_t>(next + gap);
+        next += gap + 1;
+    }
+}
+// ============================================================================
@@ -0,0 +1,81 @@
+#pragma once
+// ============================================================================
+#include <bslc/match_list.hpp>
+#include <bslc/span.hpp>
+
+#include <fastac/adaptive_data_model.hpp>
+#include <fastac/arithmetic_codec.hpp>
+
+#include <cstdint>
+#include <vector>
+// ============================================================================
+// Many small lists in one arithmetic code stream. Coding each on its own
+// (batch_compressor) pays for coder setup, termination bytes and model
+// warm-up once per list; here the lists share the coder and the adaptive
+// models, and each costs its match count (a few bits) on top of its gaps.
+//
+// Lists are grouped in blocks of `lists_per_block` (at most 65536). The
+// coder is restarted and the models reset at every block, so a single list
+// is decoded by seeking to its block through the directory and decoding from
+// there; larger blocks compress better, smaller ones make single lists
+// cheaper to reach.
+//
+// Every list: match count (bit length, mantissa), then its gaps coded as in
+// gap_codec with the adaptive model of the list's density class (see
+// gap_models.hpp).
+//
+// Layout:
+//   varint universe
+//   varint list_count
+//   varint lists_per_block
+//   block_count x varint block byte_count (directory)
+//   blocks, back to back
+class multi_list_codec
+{
+public:
+    // Universe = number of possible values, at most MAX_UNIVERSE
+    explicit multi_list_codec(uint32_t lists_per_block = 256, uint64_t universe = NUM_VALUES);
+
+    size_t max_compressed_size(span<match_list_t const> lists) const;
+    size_t list_count(span<uint8_t const> compressed);
+
+    size_t compress_into(span<match_list_t const> lists, span<uint8_t> compressed);
+    buffer_t compress(span<match_list_t const> lists);
+
+    // All lists, in one pass
+    void decompress(span<uint8_t const> compressed, std::vector<match_list_t>& lists);
+    // List `index` only, decoding from the start of its block
+    void decompress_list(span<uint8_t const> compressed, size_t index, match_list_t& matches);
+
+private:
+    // Parses the header and directory into `block_offsets`, returns the
+    // list count
+    uint64_t read_header(span<uint8_t const> compressed);
+
+    void reset_models();
+    void encode_list(span<uint32_t const> matches);
+    // Decodes the next list of the block into `matches`
+    void decode_list(match_list_t& matches);
+
+private:
+    uint32_t lists_per_block;
+    uint64_t universe;
+
+    // Long-lived coder state, reused across calls. Both work directly on the
+    // caller's buffers.
+    arithmetic_codec encoder;
+    arithmetic_codec decoder;
+    adaptive_data_model count_model;
+    std::vector<adaptive_data_model> length_models;
+    // Fresh models the ones above are restored from at every block
+    adaptive_data_model fresh_count_model;
+    adaptive_data_model fresh_length_model;
+
+    // Of the last stream read: universe, lists per block and where each
+    // block starts (one past the last block at the end)
+    uint64_t list_universe;
+    uint64_t list_block_size;
+    std::vector<size_t> block_offsets;
+    match_list_t skipped;
+};
+// ============================================================================
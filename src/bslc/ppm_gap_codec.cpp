@@ -0,0 +1,118 @@
+#include <bslc/ppm_gap_codec.hpp>
+
+#include <bslc/bit_set.hpp>
+#include <bslc/gap_coding.hpp>
+#include <bslc/varint.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+// ============================================================================
+// FastAC limits code buffers to 16 MB
+static size_t const MAX_CODE_BYTES(0x1000000);
+// Gap bit lengths 0 ... 32
+static uint32_t const LENGTH_SYMBOLS(33);
+// A list of a few million gaps fits, longer ones flush their contexts
+static size_t const MODEL_MEMORY(8 << 20);
+// ============================================================================
+ppm_gap_codec::ppm_gap_codec(uint32_t order, uint64_t universe)
+    : universe(universe)
+    , length_model(LENGTH_SYMBOLS, order, MODEL_MEMORY)
+{
+    check_universe(universe);
+}
+// ============================================================================
+size_t ppm_gap_codec::max_compressed_size(uint32_t match_count) const
+{
+    // Every context on the escape path costs at most 15 bits, the uniform
+    // order -1 model 6 bits, mantissas at most 31 bits
+    size_t const length_bits((length_model.order() + 1) * 15 + 6);
+    return varint_size(universe) + varint_size(match_count)
+        + (size_t(match_count) * (length_bits + 31) + 7) / 8 + 16;
+}
+// ----------------------------------------------------------------------------
+size_t ppm_gap_codec::decompressed_size(span<uint8_t const> compressed)
+{
+    size_t offset(0);
+    get_varint(compressed, offset);
+    return static_cast<size_t>(get_varint(compressed, offset));
+}
+// ============================================================================
+size_t ppm_gap_codec::compress_into(span<uint32_t const> matches, span<uint8_t> compressed)
+{
+    check_matches(matches, universe);
+
+    size_t offset(0);
+    put_varint(compressed, offset, universe);
+    put_varint(compressed, offset, matches.size());
+    if (matches.empty()) {
+        return offset;
+    }
+
+    // Code straight into the output, the encoder throws when it runs out
+    size_t const code_bytes(std::min(compressed.size() - offset, MAX_CODE_BYTES));
+    if (code_bytes < 3) {
+        throw std::runtime_error("Output buffer too small.");
+    }
+    encoder.set_buffer(static_cast<uint32_t>(code_bytes), compressed.data() + offset);
+    encoder.start_encoder();
+    length_model.reset();
+
+    uint64_t next(0);
+    for (uint32_t match : matches) {
+        uint32_t const gap(static_cast<uint32_t>(match - next));
+        uint32_t const length(bit_width(gap));
+        length_model.encode(length, encoder);
+        encode_gap_mantissa(encoder, gap, length);
+        next = uint64_t(match) + 1;
+    }
+
+    size_t size(encoder.stop_encoder());
+    // Decoder always starts by reading 3 bytes
+    for (; size < 3; ++size) {
+        compressed[offset + size] = 0;
+    }
+    return offset + size;
+}
+// ----------------------------------------------------------------------------
+size_t ppm_gap_codec::decompress_into(span<uint8_t const> compressed, span<uint32_t> matches)
+{
+    size_t offset(0);
+    uint64_t const list_universe(get_varint(compressed, offset));
+    check_universe(list_universe);
+    uint64_t const match_count(get_varint(compressed, offset));
+    if (match_count > list_universe) {
+        throw std::runtime_error("Invalid match count.");
+    }
+    if (match_count > matches.size()) {
+        throw std::runtime_error("Match buffer too small.");
+    }
+    if (match_count == 0) {
+        return 0;
+    }
+
+    size_t const code_bytes(std::min(compressed.size() - offset, MAX_CODE_BYTES));
+    if (code_bytes < 3) {
+        throw std::runtime_error("Truncated header.");
+    }
+
+    // Decoder only reads from the buffer
+    decoder.set_buffer(static_cast<uint32_t>(code_bytes)
+        , const_cast<uint8_t*>(compressed.data() + offset));
+    decoder.start_decoder();
+    length_model.reset();
+
+    uint64_t next(0);
+    for (uint64_t i(0); i < match_count; ++i) {
+        uint64_t const gap(decode_gap_mantissa(decoder, length_model.decode(decoder)));
+        if (next + gap >= list_universe) {
+            decoder.stop_decoder();
+            throw std::runtime_error("Match out of range.");
+        }
+        matches[i] = static_cast<uint32_t>(next + gap);
+        next += gap + 1;
+    }
+
+    decoder.stop_decoder();
+    return static_cast<size_t>(match_count);
+}
+// ============================================================================
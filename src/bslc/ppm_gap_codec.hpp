@@ -0,0 +1,45 @@
+#pragma once
+// ============================================================================
+#include <bslc/codec_base.hpp>
+#include <bslc/match_list.hpp>
+#include <bslc/ppm_model.hpp>
+#include <bslc/span.hpp>
+
+#include <fastac/arithmetic_codec.hpp>
+
+#include <cstdint>
+// ============================================================================
+// Gaps coded as in gap_codec (bit length, then the bits below the leading
+// one), the bit lengths with an order-N ppm_model over the lengths of the
+// gaps before. Order 0 codes about as gap_codec does; higher orders pay
+// off only where the lengths repeat in patterns (runs, bursts followed by
+// long skips) and cost a few percent on lists long enough to train them,
+// more on short ones, where every context escapes a while first.
+//
+// Layout:
+//   varint universe
+//   varint match_count
+//   arithmetic code: match_count x (gap bit length, gap mantissa)
+class ppm_gap_codec
+    : public codec_base<ppm_gap_codec>
+{
+public:
+    // Universe = number of possible values, at most MAX_UNIVERSE
+    explicit ppm_gap_codec(uint32_t order = 1, uint64_t universe = NUM_VALUES);
+
+    size_t max_compressed_size(uint32_t match_count) const;
+    size_t decompressed_size(span<uint8_t const> compressed);
+
+    size_t compress_into(span<uint32_t const> matches, span<uint8_t> compressed);
+    size_t decompress_into(span<uint8_t const> compressed, span<uint32_t> matches);
+
+private:
+    uint64_t universe;
+
+    // Long-lived coder state, reused across calls. Both work directly on the
+    // caller's buffers.
+    arithmetic_codec encoder;
+    arithmetic_codec decoder;
+    ppm_model length_model;
+};
+// ============================================================================
@@ -0,0 +1,212 @@
+#include <bslc/ppm_model.hpp>
+
+#include <bslc/bit_set.hpp>
+
+#include <new>
+#include <stdexcept>
+// ============================================================================
+// Keys are the context length in the top 4 bits over the history bits
+static uint32_t const LENGTH_SHIFT(60);
+static uint32_t const MAX_ORDER(15);
+static size_t const MIN_SLOTS(1 << 10);
+static size_t const ARENA_BLOCK(1 << 20);
+// ----------------------------------------------------------------------------
+static size_t hash_slot(uint64_t key, uint32_t shift)
+{
+    return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> shift);
+}
+// ============================================================================
+ppm_model::ppm_model(uint32_t symbol_count, uint32_t order, size_t memory_limit)
+    : symbols(symbol_count)
+    , max_order(order)
+    , symbol_bits(0)
+    , memory_limit(memory_limit)
+    , history(0)
+    , history_length(0)
+    , contexts(ARENA_BLOCK)
+    , arena_used(0)
+    , table(nullptr)
+    , table_size(0)
+    , table_used(0)
+    , table_shift(64)
+    , flushes(0)
+{
+    if ((symbol_count < 2) || (symbol_count > (1 << 11))) {
+        throw std::runtime_error("PPM alphabet size out of range.");
+    }
+    symbol_bits = bit_width(uint64_t(symbol_count - 1));
+    if ((order > MAX_ORDER) || (order * symbol_bits > LENGTH_SHIFT)) {
+        throw std::runtime_error("PPM order too large for the alphabet.");
+    }
+
+    order0.set_alphabet(symbol_count);
+    uniform.set_distribution(symbol_count);
+    escaped.reserve(order + 1);
+    allocate_table(MIN_SLOTS);
+}
+// ----------------------------------------------------------------------------
+ppm_model::~ppm_model()
+{
+    drop_contexts();
+}
+// ============================================================================
+void ppm_model::reset()
+{
+    drop_contexts();
+    contexts.reset();
+    arena_used = 0;
+    allocate_table(MIN_SLOTS);
+    order0.reset();
+    history = 0;
+    history_length = 0;
+}
+// ----------------------------------------------------------------------------
+void ppm_model::encode(uint32_t symbol, arithmetic_codec& encoder)
+{
+    if (symbol >= symbols) {
+        throw std::runtime_error("Symbol out of range.");
+    }
+    begin_symbol();
+
+    for (uint32_t length(history_length); length > 0; --length) {
+        adaptive_esc_data_model& model(context(length));
+        if (model.has_symbol(symbol)) {
+            encoder.encode(symbol, model);
+            end_symbol(symbol);
+            return;
+        }
+        encoder.encode(model.get_escape(), model);
+        escaped.push_back(&model);
+    }
+
+    if (order0.has_symbol(symbol)) {
+        encoder.encode(symbol, order0);
+    } else {
+        encoder.encode(order0.get_escape(), order0);
+        encoder.encode(symbol, uniform);
+        escaped.push_back(&order0);
+    }
+    end_symbol(symbol);
+}
+// ----------------------------------------------------------------------------
+uint32_t ppm_model::decode(arithmetic_codec& decoder)
+{
+    begin_symbol();
+
+    for (uint32_t length(history_length); length > 0; --length) {
+        adaptive_esc_data_model& model(context(length));
+        uint32_t const symbol(decoder.decode(model));
+        if (!model.is_escape(symbol)) {
+            end_symbol(symbol);
+            return symbol;
+        }
+        escaped.push_back(&model);
+    }
+
+    uint32_t symbol(decoder.decode(order0));
+    if (order0.is_escape(symbol)) {
+        symbol = decoder.decode(uniform);
+        escaped.push_back(&order0);
+    }
+    end_symbol(symbol);
+    return symbol;
+}
+// ============================================================================
+adaptive_esc_data_model& ppm_model::context(uint32_t length)
+{
+    uint64_t const mask((uint64_t(1) << (length * symbol_bits)) - 1);
+    uint64_t const key((uint64_t(length) << LENGTH_SHIFT) | (history & mask));
+
+    size_t const slot_mask(table_size - 1);
+    size_t i(hash_slot(key, table_shift));
+    for (; table[i].key != 0; i = (i + 1) & slot_mask) {
+        if (table[i].key == key) {
+            return *table[i].model;
+        }
+    }
+
+    size_t const words(adaptive_esc_data_model::memory_words(symbols));
+    void* const memory(contexts.allocate(sizeof(adaptive_esc_data_model) + words * sizeof(uint32_t)));
+    arena_used += sizeof(adaptive_esc_data_model) + words * sizeof(uint32_t);
+    adaptive_esc_data_model* const model(new (memory) adaptive_esc_data_model());
+    model->set_alphabet(symbols, reinterpret_cast<uint32_t*>(model + 1));
+
+    table[i].key = key;
+    table[i].model = model;
+    ++table_used;
+
+    // At most half full; the old table stays in the arena until the next flush
+    if (2 * table_used > table_size) {
+        slot* const old(table);
+        size_t const old_size(table_size);
+        allocate_table(2 * table_size);
+        for (size_t s(0); s < old_size; ++s) {
+            if (old[s].key != 0) {
+                size_t j(hash_slot(old[s].key, table_shift));
+                while (table[j].key != 0) {
+                    j = (j + 1) & (table_size - 1);
+                }
+                table[j] = old[s];
+                ++table_used;
+            }
+        }
+    }
+    return *model;
+}
+// ----------------------------------------------------------------------------
+void ppm_model::allocate_table(size_t size)
+{
+    table = static_cast<slot*>(contexts.allocate(size * sizeof(slot)));
+    arena_used += size * sizeof(slot);
+    for (size_t s(0); s < size; ++s) {
+        table[s].key = 0;
+        table[s].model = nullptr;
+    }
+    table_size = size;
+    table_used = 0;
+    table_shift = 64;
+    for (size_t s(size); s > 1; s >>= 1) {
+        --table_shift;
+    }
+}
+// ----------------------------------------------------------------------------
+void ppm_model::drop_contexts()
+{
+    // The models' memory is the arena's, the destructors just run for form
+    for (size_t s(0); s < table_size; ++s) {
+        if (table[s].key != 0) {
+            table[s].model->~adaptive_esc_data_model();
+        }
+    }
+    table_size = 0;
+    table_used = 0;
+}
+// ----------------------------------------------------------------------------
+void ppm_model::begin_symbol()
+{
+    // Checked between symbols only, so the decoder flushes where the encoder did
+    if (arena_used >= memory_limit) {
+        drop_contexts();
+        contexts.reset();
+        arena_used = 0;
+        allocate_table(MIN_SLOTS);
+        ++flushes;
+    }
+    escaped.clear();
+}
+// ----------------------------------------------------------------------------
+void ppm_model::end_symbol(uint32_t symbol)
+{
+    for (adaptive_esc_data_model* model : escaped) {
+        model->add_symbol(symbol);
+    }
+
+    if (max_order != 0) {
+        uint64_t const mask((uint64_t(1) << (max_order * symbol_bits)) - 1);
+        history = ((history << symbol_bits) | symbol) & mask;
+        if (history_length < max_order) {
+            ++history_length;
+        }
+    }
+}
+// ============================================================================
@@ -0,0 +1,111 @@
+#pragma once
+// ============================================================================
+#include <bslc/arena.hpp>
+
+#include <fastac/adaptive_esc_data_model.hpp>
+#include <fastac/arithmetic_codec.hpp>
+#include <fastac/static_data_model.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+// ============================================================================
+// Order-N context model (PPM) over an alphabet of up to 2048 symbols.
+//
+// Each symbol is coded in the longest context seen so far; when that context
+// hasn't seen the symbol yet an escape is coded and the next shorter context
+// is tried, down to order 0 and finally a uniform order -1 model. Contexts
+// are created on first use in a hash table keyed by the exact symbol history,
+// with the table and all the context models in one arena. Once the arena
+// holds `memory_limit` bytes everything above order 0 is dropped and the
+// model starts learning again, at the same point in encoder and decoder.
+//
+// encode() and decode() are exact mirrors: a decoder built with the same
+// parameters and fed the same calls reproduces the encoder's state.
+class ppm_model
+{
+public:
+    ppm_model(uint32_t symbol_count, uint32_t order, size_t memory_limit = 32 << 20);
+    ~ppm_model();
+
+    ppm_model(ppm_model const&) = delete;
+    ppm_model& operator=(ppm_model const&) = delete;
+
+    // Empty history, no contexts, order 0 back to all escapes
+    void reset();
+
+    void encode(uint32_t symbol, arithmetic_codec& encoder);
+    uint32_t decode(arithmetic_codec& decoder);
+
+    uint32_t symbol_count() const;
+    uint32_t order() const;
+    // Contexts above order 0 currently held
+    size_t context_count() const;
+    // Arena bytes in use
+    size_t memory_usage() const;
+    // Times the contexts were dropped for the memory limit
+    size_t flush_count() const;
+
+private:
+    struct slot
+    {
+        uint64_t key; // 0 = free
+        adaptive_esc_data_model* model;
+    };
+
+    adaptive_esc_data_model& context(uint32_t length);
+    void allocate_table(size_t size);
+    void drop_contexts();
+    void begin_symbol();
+    void end_symbol(uint32_t symbol);
+
+private:
+    uint32_t symbols;
+    uint32_t max_order;
+    uint32_t symbol_bits;
+    size_t memory_limit;
+
+    // The last `max_order` symbols, newest in the low bits
+    uint64_t history;
+    uint32_t history_length;
+
+    arena contexts;
+    size_t arena_used;
+    slot* table;
+    size_t table_size;
+    size_t table_used;
+    uint32_t table_shift;
+    size_t flushes;
+
+    adaptive_esc_data_model order0;
+    static_data_model uniform;
+
+    // Contexts that escaped on the current symbol
+    std::vector<adaptive_esc_data_model*> escaped;
+};
+// ============================================================================
+inline uint32_t ppm_model::symbol_count() const
+{
+    return symbols;
+}
+// ----------------------------------------------------------------------------
+inline uint32_t ppm_model::order() const
+{
+    return max_order;
+}
+// ----------------------------------------------------------------------------
+inline size_t ppm_model::context_count() const
+{
+    return table_used;
+}
+// ----------------------------------------------------------------------------
+inline size_t ppm_model::memory_usage() const
+{
+    return arena_used;
+}
+// ----------------------------------------------------------------------------
+inline size_t ppm_model::flush_count() const
+{
+    return flushes;
+}
+// ============================================================================
@@ -0,0 +1,236 @@
+#include <bslc/segmented_codec.hpp>
+
+#include <bslc/bitmap_coding.hpp>
+#include <bslc/size_bounds.hpp>
+#include <bslc/varint.hpp>
+
+#include <fastac/static_bit_model.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+// ============================================================================
+segmented_codec::segmented_codec(uint32_t segment_count, thread_pool* pool, uint64_t universe)
+    : universe(universe)
+    , segment_count(segment_count)
+    , pool(pool)
+{
+    check_universe(universe);
+    if ((segment_count == 0) || (segment_count > universe)) {
+        throw std::runtime_error("Invalid segment count.");
+    }
+
+    size_t worker_count(pool ? pool->size() : 1);
+    for (size_t i(0); i < worker_count; ++i) {
+        encoders.push_back(std::make_unique<arithmetic_codec>());
+        decoders.push_back(std::make_unique<arithmetic_codec>());
+    }
+}
+// ============================================================================
+size_t segmented_codec::max_compressed_size(uint32_t match_count) const
+{
+    // Splitting only lets each segment follow its local density, so the
+    // static bound holds for the data. Per segment: two header varints,
+    // coder flush and padding.
+    size_t bound(static_bit_model_bound(universe, match_count));
+    return varint_size(universe) + varint_size(segment_count)
+        + bound + bound / 100 + size_t(segment_count) * 24;
+}
+// ----------------------------------------------------------------------------
+size_t segmented_codec::decompressed_size(span<uint8_t const> compressed)
+{
+    return static_cast<size_t>(read_header(compressed));
+}
+// ============================================================================
+size_t segmented_codec::compress_into(span<uint32_t const> matches, span<uint8_t> compressed)
+{
+    check_matches(matches, universe);
+
+    set_segment_ranges(universe, segment_count);
+    segment_data.resize(segment_count);
+
+    // Split the matches along the segment boundaries
+    uint32_t const* it(matches.begin());
+    for (auto& s : segments) {
+        uint32_t const* last(std::lower_bound(it, matches.end(), s.first_value + s.value_count));
+        s.first_match = static_cast<uint32_t>(it - matches.begin());
+        s.match_count = static_cast<uint32_t>(last - it);
+        it = last;
+    }
+
+    for_each_segment([&](size_t worker, size_t i) {
+        encode_segment(*encoders[worker], matches.data(), segments[i], segment_data[i]);
+    });
+
+    size_t offset(0);
+    put_varint(compressed, offset, universe);
+    put_varint(compressed, offset, segment_count);
+    for (uint32_t i(0); i < segment_count; ++i) {
+        put_varint(compressed, offset, segments[i].match_count);
+        put_varint(compressed, offset, segment_data[i].size());
+    }
+    for (auto const& data : segment_data) {
+        if (offset + data.size() > compressed.size()) {
+            throw std::runtime_error("Output buffer too small.");
+        }
+        if (!data.empty()) {
+            std::memcpy(compressed.data() + offset, data.data(), data.size());
+        }
+        offset += data.size();
+    }
+
+    return offset;
+}
+// ============================================================================
+size_t segmented_codec::decompress_into(span<uint8_t const> compressed, span<uint32_t> matches)
+{
+    uint64_t match_total(read_header(compressed));
+    if (match_total > matches.size()) {
+        throw std::runtime_error("Match buffer too small.");
+    }
+
+    for_each_segment([&](size_t worker, size_t i) {
+        segment const& s(segments[i]);
+        decode_segment(*decoders[worker]
+            , compressed.data() + s.offset
+            , s
+            , matches.data() + s.first_match);
+    });
+
+    return static_cast<size_t>(match_total);
+}
+// ============================================================================
+void segmented_codec::set_segment_ranges(uint64_t list_universe, uint32_t count)
+{
+    segments.resize(count);
+    for (uint32_t i(0); i < count; ++i) {
+        uint64_t first(list_universe * i / count);
+        uint64_t last(list_universe * (i + 1) / count);
+        segments[i].first_value = first;
+        segments[i].value_count = last - first;
+    }
+}
+// ----------------------------------------------------------------------------
+uint64_t segmented_codec::read_header(span<uint8_t const> compressed)
+{
+    size_t offset(0);
+    uint64_t const list_universe(get_varint(compressed, offset));
+    check_universe(list_universe);
+    uint64_t count(get_varint(compressed, offset));
+    if ((count == 0) || (count > list_universe)) {
+        throw std::runtime_error("Invalid segment count.");
+    }
+    set_segment_ranges(list_universe, static_cast<uint32_t>(count));
+
+    uint64_t match_total(0);
+    for (auto& s : segments) {
+        uint64_t const match_count(get_varint(compressed, offset));
+        if (match_count > s.value_count) {
+            throw std::runtime_error("Invalid segment header.");
+        }
+        s.match_count = static_cast<uint32_t>(match_count);
+        s.size = static_cast<size_t>(get_varint(compressed, offset));
+        s.first_match = static_cast<uint32_t>(match_total);
+        match_total += s.match_count;
+    }
+    // Checked one by one, crafted sizes could wrap a sum
+    for (auto& s : segments) {
+        if (s.size > compressed.size() - offset) {
+            throw std::runtime_error("Truncated segment data.");
+        }
+        s.offset = offset;
+        offset += s.size;
+    }
+
+    return match_total;
+}
+// ----------------------------------------------------------------------------
+template <typename Task>
+void segmented_codec::for_each_segment(Task const& task)
+{
+    if (pool) {
+        pool->run(segments.size(), task);
+    } else {
+        for (size_t i(0); i < segments.size(); ++i) {
+            task(0, i);
+        }
+    }
+}
+// ============================================================================
+void segmented_codec::encode_segment(arithmetic_codec& encoder
+    , uint32_t const* matches
+    , segment const& s
+    , buffer_t& output)
+{
+    // Empty segments take no space at all
+    output.clear();
+    if (s.match_count == 0) {
+        return;
+    }
+
+    // The encoder throws rather than overrun the buffer
+    size_t bound(static_bit_model_bound(s.value_count, s.match_count));
+    bound = std::min<size_t>(bound + bound / 100 + 64, 0x1000000);
+    encoder.set_buffer(static_cast<uint32_t>(bound));
+    encoder.start_encoder();
+
+    static_bit_model model;
+    uint64_t match_count(s.match_count);
+    uint64_t total_count(s.value_count);
+
+    uint32_t const* match(matches + s.first_match);
+    for (uint64_t i(s.first_value); match_count > 0; ++i) {
+        uint32_t entry((*match == i) ? 1 : 0);
+        model.set_probability_0(bitmap_probability_0(match_count, total_count));
+        encoder.encode(entry, model);
+        --total_count;
+        if (entry) {
+            --match_count;
+            ++match;
+        }
+    }
+
+    uint32_t compressed_size = encoder.stop_encoder();
+    output.assign(encoder.buffer(), encoder.buffer() + compressed_size);
+    // Decoder always starts by reading 4 bytes
+    if (output.size() < 4) {
+        output.resize(4, 0);
+    }
+}
+// ----------------------------------------------------------------------------
+void segmented_codec::decode_segment(arithmetic_codec& decoder
+    , uint8_t const* data
+    , segment const& s
+    , uint32_t* output)
+{
+    if (s.match_count == 0) {
+        return;
+    }
+    if (s.size < 4) {
+        throw std::runtime_error("Invalid segment size.");
+    }
+
+    // Decoder only reads from the buffer
+    decoder.set_buffer(static_cast<uint32_t>(s.size), const_cast<uint8_t*>(data));
+    decoder.start_decoder();
+
+    static_bit_model model;
+    uint64_t match_count(s.match_count);
+    uint64_t total_count(s.value_count);
+
+    for (uint64_t i(s.first_value); match_count > 0; ++i) {
+        if (total_count == 0) {
+            decoder.stop_decoder();
+            throw std::runtime_error("Corrupted segment data.");
+        }
+        model.set_probability_0(bitmap_probability_0(match_count, total_count));
+        if (decoder.decode(model) == 1) {
+            *output++ = static_cast<uint32_t>(i);
+            --match_count;
+        }
+        --total_count;
+    }
+
+    decoder.stop_decoder();
+}
+// ============================================================================
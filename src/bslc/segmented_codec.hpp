@@ -0,0 +1,78 @@
+#pragma once
+// ============================================================================
+#include <bslc/codec_base.hpp>
+#include <bslc/match_list.hpp>
+#include <bslc/span.hpp>
+#include <bslc/thread_pool.hpp>
+
+#include <fastac/arithmetic_codec.hpp>
+
+#include <memory>
+#include <vector>
+// ============================================================================
+// Universe split into equal ranges, each coded independently (as in v2).
+//
+// Layout:
+//   varint universe
+//   varint segment_count
+//   segment_count x (varint match_count, varint byte_count)
+//   segment data, back to back
+//
+// The header gives both the byte offset of every segment and the position of
+// its matches in the output, so segments can be decoded in parallel straight
+// into the result vector.
+class segmented_codec
+    : public codec_base<segmented_codec>
+{
+public:
+    // No pool = segments are processed on the calling thread
+    explicit segmented_codec(uint32_t segment_count = 16
+        , thread_pool* pool = nullptr
+        , uint64_t universe = NUM_VALUES);
+
+    size_t max_compressed_size(uint32_t match_count) const;
+    size_t decompressed_size(span<uint8_t const> compressed);
+
+    size_t compress_into(span<uint32_t const> matches, span<uint8_t> compressed);
+    size_t decompress_into(span<uint8_t const> compressed, span<uint32_t> matches);
+
+private:
+    struct segment
+    {
+        uint64_t first_value;
+        uint64_t value_count;
+        uint32_t first_match;
+        uint32_t match_count;
+        size_t offset;
+        size_t size;
+    };
+
+    void set_segment_ranges(uint64_t list_universe, uint32_t count);
+    // Parses the header into `segments`, returns the total match count
+    uint64_t read_header(span<uint8_t const> compressed);
+
+    void encode_segment(arithmetic_codec& encoder
+        , uint32_t const* matches
+        , segment const& s
+        , buffer_t& output);
+    void decode_segment(arithmetic_codec& decoder
+        , uint8_t const* data
+        , segment const& s
+        , uint32_t* output);
+
+    template <typename Task>
+    void for_each_segment(Task const& task);
+
+private:
+    uint64_t universe;
+    uint32_t segment_count;
+    thread_pool* pool;
+
+    // Per worker coder state
+    std::vector<std::unique_ptr<arithmetic_codec>> encoders;
+    std::vector<std::unique_ptr<arithmetic_codec>> decoders;
+
+    std::vector<segment> segments;
+    std::vector<buffer_t> segment_data;
+};
+// ============================================================================
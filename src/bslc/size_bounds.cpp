@@ -0,0 +1,40 @@
+#include <bslc/size_bounds.hpp>
+
+#include <bslc/bitmap_coding.hpp>
+
+#include <fastac/constants.hpp>
+#include <fastac/static_bit_model.hpp>
+
+#include <cmath>
+// ============================================================================
+size_t static_bit_model_bound(uint64_t value_count, uint64_t match_count, double probability_0)
+{
+    if (value_count == 0) {
+        return 8;
+    }
+
+    static_bit_model model;
+    model.set_probability_0(probability_0);
+
+    double const scale(double(1 << BM__LengthShift));
+    double const scaled_0(model.scaled_probability_0());
+    double const cost_0(-std::log2(scaled_0 / scale));
+    double const cost_1(-std::log2((scale - scaled_0) / scale));
+
+    double bits(double(match_count) * cost_1 + double(value_count - match_count) * cost_0);
+    // Interval truncation, at most ~0.0007 bits per symbol
+    bits += 0.001 * double(value_count);
+
+    return static_cast<size_t>(std::ceil(bits / 8)) + 16;
+}
+// ----------------------------------------------------------------------------
+size_t static_bit_model_bound(uint64_t value_count, uint64_t match_count)
+{
+    if ((value_count == 0) || (match_count == 0)) {
+        return 8;
+    }
+    return static_bit_model_bound(value_count
+        , match_count
+        , bitmap_probability_0(match_count, value_count));
+}
+// ============================================================================
@@ -0,0 +1,14 @@
+#pragma once
+// ============================================================================
+#include <cstddef>
+#include <cstdint>
+// ============================================================================
+// Upper bound in bytes of `value_count` bits holding `match_count` ones, coded
+// by arithmetic_codec with a static_bit_model set to `probability_0`.
+//
+// Covers the 13 bit quantization of the model, the truncation in the interval
+// update (< 2^-11 relative per symbol) and the final flush bytes.
+size_t static_bit_model_bound(uint64_t value_count, uint64_t match_count, double probability_0);
+// Same, with the model set to the match density (as the codecs do)
+size_t static_bit_model_bound(uint64_t value_count, uint64_t match_count);
+// ============================================================================
@@ -0,0 +1,121 @@
+#include <bslc/snappy_codec.hpp>
+
+#include <bslc/varint.hpp>
+
+#include <snappy-c.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+// ============================================================================
+snappy_codec::snappy_codec(uint32_t bits_per_symbol, uint64_t universe)
+    : bits_per_symbol(bits_per_symbol)
+    , universe(universe)
+    , chunk(BITMAP_CHUNK_SIZE)
+    , chunk_compressed(snappy_max_compressed_length(BITMAP_CHUNK_SIZE))
+{
+    check_universe(universe);
+}
+// ============================================================================
+size_t snappy_codec::max_compressed_size(uint32_t match_count) const
+{
+    size_t const total(symbol_count(static_cast<uint8_t>(bits_per_symbol), universe));
+    size_t const chunk_count((total + BITMAP_CHUNK_SIZE - 1) / BITMAP_CHUNK_SIZE);
+    size_t const chunk_bound(snappy_max_compressed_length(BITMAP_CHUNK_SIZE));
+    return varint_size(universe) + varint_size(match_count)
+        + chunk_count * (varint_size(chunk_bound) + chunk_bound);
+}
+// ----------------------------------------------------------------------------
+size_t snappy_codec::decompressed_size(span<uint8_t const> compressed)
+{
+    size_t offset(0);
+    check_universe(get_varint(compressed, offset));
+    return static_cast<size_t>(get_varint(compressed, offset));
+}
+// ============================================================================
+size_t snappy_codec::compress_into(span<uint32_t const> matches, span<uint8_t> compressed)
+{
+    check_matches(matches, universe);
+
+    size_t offset(0);
+    put_varint(compressed, offset, universe);
+    put_varint(compressed, offset, matches.size());
+
+    size_t const total(symbol_count(static_cast<uint8_t>(bits_per_symbol), universe));
+    size_t consumed(0);
+    for (size_t first(0); first < total; first += BITMAP_CHUNK_SIZE) {
+        size_t size(std::min(BITMAP_CHUNK_SIZE, total - first));
+        consumed += make_symbols(matches.subspan(consumed)
+            , static_cast<uint8_t>(bits_per_symbol)
+            , first
+            , span<uint8_t>(chunk.data(), size));
+
+        size_t compressed_size(chunk_compressed.size());
+        snappy_status err = snappy_compress((char const*)chunk.data()
+            , size
+            , (char*)chunk_compressed.data()
+            , &compressed_size);
+        if (err != SNAPPY_OK) {
+            throw std::runtime_error("Compression error.");
+        }
+
+        put_varint(compressed, offset, compressed_size);
+        if (offset + compressed_size > compressed.size()) {
+            throw std::runtime_error("Output buffer too small.");
+        }
+        std::memcpy(compressed.data() + offset, chunk_compressed.data(), compressed_size);
+        offset += compressed_size;
+    }
+    if (consumed != matches.size()) {
+        throw std::runtime_error("Match out of range.");
+    }
+
+    return offset;
+}
+// ----------------------------------------------------------------------------
+size_t snappy_codec::decompress_into(span<uint8_t const> compressed, span<uint32_t> matches)
+{
+    size_t offset(0);
+    uint64_t const list_universe(get_varint(compressed, offset));
+    check_universe(list_universe);
+    uint64_t match_count(get_varint(compressed, offset));
+    if (match_count > list_universe) {
+        throw std::runtime_error("Invalid match count.");
+    }
+    if (match_count > matches.size()) {
+        throw std::runtime_error("Match buffer too small.");
+    }
+
+    size_t const total(symbol_count(static_cast<uint8_t>(bits_per_symbol), list_universe));
+    size_t count(0);
+    for (size_t first(0); first < total; first += BITMAP_CHUNK_SIZE) {
+        size_t size(std::min(BITMAP_CHUNK_SIZE, total - first));
+
+        size_t compressed_size(static_cast<size_t>(get_varint(compressed, offset)));
+        if (offset + compressed_size > compressed.size()) {
+            throw std::runtime_error("Truncated chunk data.");
+        }
+
+        size_t decompressed_size(size);
+        snappy_status err = snappy_uncompress((char const*)compressed.data() + offset
+            , compressed_size
+            , (char*)chunk.data()
+            , &decompressed_size);
+        if ((err != SNAPPY_OK) || (decompressed_size != size)) {
+            throw std::runtime_error("Decompression error.");
+        }
+        offset += compressed_size;
+
+        count = make_matches(span<uint8_t const>(chunk.data(), size)
+            , static_cast<uint8_t>(bits_per_symbol)
+            , first
+            , matches.first(static_cast<size_t>(match_count))
+            , count);
+    }
+
+    if (count != match_count) {
+        throw std::runtime_error("Size mismatch.");
+    }
+    return count;
+}
+// ============================================================================
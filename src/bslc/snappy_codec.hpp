@@ -0,0 +1,35 @@
+#pragma once
+// ============================================================================
+#include <bslc/codec_base.hpp>
+#include <bslc/match_list.hpp>
+#include <bslc/span.hpp>
+// ============================================================================
+// Bitmap with `bits_per_symbol` values per byte, compressed with snappy
+//
+// Layout:
+//   varint universe
+//   varint match_count
+//   per BITMAP_CHUNK_SIZE slice of the bitmap (varint byte_count, snappy block)
+//
+// Slices are compressed independently, so both directions only ever hold
+// one slice of the bitmap.
+class snappy_codec
+    : public codec_base<snappy_codec>
+{
+public:
+    // Universe = number of possible values, at most MAX_UNIVERSE
+    explicit snappy_codec(uint32_t bits_per_symbol, uint64_t universe = NUM_VALUES);
+
+    size_t max_compressed_size(uint32_t match_count) const;
+    size_t decompressed_size(span<uint8_t const> compressed);
+
+    size_t compress_into(span<uint32_t const> matches, span<uint8_t> compressed);
+    size_t decompress_into(span<uint8_t const> compressed, span<uint32_t> matches);
+
+private:
+    uint32_t bits_per_symbol;
+    uint64_t universe;
+    match_symbols_t chunk;
+    buffer_t chunk_compressed;
+};
+// ============================================================================
@@ -0,0 +1,53 @@
+#pragma once
+// ============================================================================
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+// ============================================================================
+// Non-owning view of a contiguous sequence (subset of C++20 std::span)
+template <typename T>
+class span
+{
+public:
+    typedef T element_type;
+    typedef typename std::remove_cv<T>::type value_type;
+    typedef T* iterator;
+
+    span() : ptr(nullptr), count(0) {}
+    span(T* data, size_t size) : ptr(data), count(size) {}
+    span(T* first, T* last) : ptr(first), count(static_cast<size_t>(last - first)) {}
+
+    template <typename U
+        , typename = typename std::enable_if<std::is_convertible<U(*)[], T(*)[]>::value>::type>
+    span(span<U> const& other) : ptr(other.data()), count(other.size()) {}
+
+    template <typename U, typename A
+        , typename = typename std::enable_if<std::is_convertible<U(*)[], T(*)[]>::value>::type>
+    span(std::vector<U, A>& v) : ptr(v.data()), count(v.size()) {}
+
+    template <typename U, typename A
+        , typename = typename std::enable_if<std::is_convertible<U const(*)[], T(*)[]>::value>::type>
+    span(std::vector<U, A> const& v) : ptr(v.data()), count(v.size()) {}
+
+    T* data() const { return ptr; }
+    size_t size() const { return count; }
+    size_t size_bytes() const { return count * sizeof(T); }
+    bool empty() const { return count == 0; }
+
+    T& operator[](size_t i) const { return ptr[i]; }
+    T& front() const { return ptr[0]; }
+    T& back() const { return ptr[count - 1]; }
+
+    iterator begin() const { return ptr; }
+    iterator end() const { return ptr + count; }
+
+    span first(size_t n) const { return span(ptr, n); }
+    span last(size_t n) const { return span(ptr + count - n, n); }
+    span subspan(size_t offset, size_t n) const { return span(ptr + offset, n); }
+    span subspan(size_t offset) const { return span(ptr + offset, count - offset); }
+
+private:
+    T* ptr;
+    size_t count;
+};
+// ============================================================================
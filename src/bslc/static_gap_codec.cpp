@@ -0,0 +1,189 @@
+#include <bslc/static_gap_codec.hpp>
+
+#include <bslc/bit_set.hpp>
+#include <bslc/gap_coding.hpp>
+#include <bslc/varint.hpp>
+
+#include <fse/fse.h>
+
+#include <algorithm>
+#include <stdexcept>
+// ============================================================================
+// FastAC limits code buffers to 16 MB
+static size_t const MAX_CODE_BYTES(0x1000000);
+// Gaps below 2^32 have bit lengths 0 ... 32
+static uint32_t const LENGTH_SYMBOLS(33);
+// Finer counts cost more header than they save on the list sizes this is for
+static uint32_t const MAX_TABLE_LOG(11);
+// ============================================================================
+static_gap_codec::static_gap_codec(uint64_t universe)
+    : universe(universe)
+{
+    check_universe(universe);
+}
+// ============================================================================
+size_t static_gap_codec::max_compressed_size(uint32_t match_count) const
+{
+    // Lengths cost at most ~11 bits (every probability >= 2^-12), mantissas
+    // at most 31 bits
+    return varint_size(universe) + varint_size(match_count)
+        + FSE_NCountWriteBound(LENGTH_SYMBOLS - 1, MAX_TABLE_LOG)
+        + size_t(match_count) * 6 + 16;
+}
+// ----------------------------------------------------------------------------
+size_t static_gap_codec::decompressed_size(span<uint8_t const> compressed)
+{
+    size_t offset(0);
+    get_varint(compressed, offset);
+    return static_cast<size_t>(get_varint(compressed, offset));
+}
+// ============================================================================
+size_t static_gap_codec::compress_into(span<uint32_t const> matches, span<uint8_t> compressed)
+{
+    check_matches(matches, universe);
+
+    size_t offset(0);
+    put_varint(compressed, offset, universe);
+    put_varint(compressed, offset, matches.size());
+    if (matches.empty()) {
+        return offset;
+    }
+
+    // First pass: length counts
+    unsigned counts[LENGTH_SYMBOLS] = {};
+    uint32_t max_length(1);
+    uint64_t next(0);
+    for (uint32_t match : matches) {
+        uint32_t const length(bit_width(match - next));
+        ++counts[length];
+        max_length = std::max(max_length, length);
+        next = uint64_t(match) + 1;
+    }
+
+    short normalized[LENGTH_SYMBOLS];
+    uint32_t const table_log(FSE_optimalTableLog(MAX_TABLE_LOG, matches.size(), max_length));
+    size_t const result(FSE_normalizeCount(normalized, table_log, counts, matches.size(), max_length));
+    if (FSE_isError(result)) {
+        throw std::runtime_error("Cannot normalize gap length counts.");
+    }
+    if (result == 0) {
+        // All gaps of one length
+        for (uint32_t length(0); length <= max_length; ++length) {
+            normalized[length] = (counts[length] != 0) ? short(1 << table_log) : short(0);
+        }
+    }
+
+    size_t const header_size(FSE_writeNCount(compressed.data() + offset
+        , compressed.size() - offset
+        , normalized
+        , max_length
+        , table_log));
+    if (FSE_isError(header_size)) {
+        throw std::runtime_error("Output buffer too small.");
+    }
+    offset += header_size;
+    set_model(normalized, max_length, table_log);
+
+    // Code straight into the output, the encoder throws when it runs out
+    size_t const code_bytes(std::min(compressed.size() - offset, MAX_CODE_BYTES));
+    if (code_bytes < 3) {
+        throw std::runtime_error("Output buffer too small.");
+    }
+    encoder.set_buffer(static_cast<uint32_t>(code_bytes), compressed.data() + offset);
+    encoder.start_encoder();
+
+    // Second pass: lengths and mantissas
+    next = 0;
+    for (uint32_t match : matches) {
+        uint32_t const gap(static_cast<uint32_t>(match - next));
+        encode_gap(encoder, length_model, gap);
+        next = uint64_t(match) + 1;
+    }
+
+    size_t size(encoder.stop_encoder());
+    // Decoder always starts by reading 3 bytes
+    for (; size < 3; ++size) {
+        compressed[offset + size] = 0;
+    }
+    return offset + size;
+}
+// ----------------------------------------------------------------------------
+size_t static_gap_codec::decompress_into(span<uint8_t const> compressed, span<uint32_t> matches)
+{
+    size_t offset(0);
+    uint64_t const list_universe(get_varint(compressed, offset));
+    check_universe(list_universe);
+    uint64_t const match_count(get_varint(compressed, offset));
+    if (match_count > list_universe) {
+        throw std::runtime_error("Invalid match count.");
+    }
+    if (match_count > matches.size()) {
+        throw std::runtime_error("Match buffer too small.");
+    }
+    if (match_count == 0) {
+        return 0;
+    }
+
+    short normalized[LENGTH_SYMBOLS];
+    unsigned max_length(LENGTH_SYMBOLS - 1);
+    unsigned table_log(0);
+    size_t const header_size(FSE_readNCount(normalized
+        , &max_length
+        , &table_log
+        , compressed.data() + offset
+        , compressed.size() - offset));
+    if (FSE_isError(header_size) || (table_log > MAX_TABLE_LOG)) {
+        throw std::runtime_error("Invalid gap length counts.");
+    }
+    offset += header_size;
+    // Trailing zero counts aren't stored, the model has at least 2 symbols
+    if (max_length < 1) {
+        normalized[1] = 0;
+        max_length = 1;
+    }
+    set_model(normalized, max_length, table_log);
+
+    size_t const code_bytes(std::min(compressed.size() - offset, MAX_CODE_BYTES));
+    if (code_bytes < 3) {
+        throw std::runtime_error("Truncated header.");
+    }
+
+    // Decoder only reads from the buffer
+    decoder.set_buffer(static_cast<uint32_t>(code_bytes)
+        , const_cast<uint8_t*>(compressed.data() + offset));
+    decoder.start_decoder();
+
+    uint64_t next(0);
+    for (uint64_t i(0); i < match_count; ++i) {
+        uint64_t const gap(decode_gap(decoder, length_model));
+        if (next + gap >= list_universe) {
+            decoder.stop_decoder();
+            throw std::runtime_error("Match out of range.");
+        }
+        matches[i] = static_cast<uint32_t>(next + gap);
+        next += gap + 1;
+    }
+
+    decoder.stop_decoder();
+    return static_cast<size_t>(match_count);
+}
+// ============================================================================
+void static_gap_codec::set_model(short const* normalized, uint32_t max_length, uint32_t table_log)
+{
+    // Lengths that are rare (-1) or absent still need a probability of their
+    // own, static_data_model takes nothing below 0.0001
+    double weights[LENGTH_SYMBOLS];
+    double total(0.0);
+    for (uint32_t length(0); length <= max_length; ++length) {
+        weights[length] = (normalized[length] > 0) ? double(normalized[length]) : 1.0;
+        total += weights[length];
+    }
+    if (total > double((1 << table_log) + LENGTH_SYMBOLS)) {
+        throw std::runtime_error("Invalid gap length counts.");
+    }
+    for (uint32_t length(0); length <= max_length; ++length) {
+        weights[length] /= total;
+    }
+    length_model.set_distribution(max_length + 1, weights);
+}
+// ============================================================================
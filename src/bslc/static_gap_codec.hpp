@@ -0,0 +1,49 @@
+#pragma once
+// ============================================================================
+#include <bslc/codec_base.hpp>
+#include <bslc/match_list.hpp>
+#include <bslc/span.hpp>
+
+#include <fastac/arithmetic_codec.hpp>
+#include <fastac/static_data_model.hpp>
+
+#include <cstdint>
+// ============================================================================
+// Gaps coded as in gap_codec (bit length, then the bits below the leading
+// one), but semi-static: a first pass counts the gap lengths, the counts are
+// normalized to a power of two total and stored with FSE_writeNCount, and
+// the lengths are coded with a static_data_model built from them. No warm-up
+// cost and no model updates; the decoder uses the model's decoder table.
+//
+// Layout:
+//   varint universe
+//   varint match_count
+//   FSE normalized counts of the gap lengths (when match_count > 0)
+//   arithmetic code: match_count x (gap bit length, gap mantissa)
+class static_gap_codec
+    : public codec_base<static_gap_codec>
+{
+public:
+    // Universe = number of possible values, at most MAX_UNIVERSE
+    explicit static_gap_codec(uint64_t universe = NUM_VALUES);
+
+    size_t max_compressed_size(uint32_t match_count) const;
+    size_t decompressed_size(span<uint8_t const> compressed);
+
+    size_t compress_into(span<uint32_t const> matches, span<uint8_t> compressed);
+    size_t decompress_into(span<uint8_t const> compressed, span<uint32_t> matches);
+
+private:
+    // Model of the normalized counts of lengths 0 .. max_length
+    void set_model(short const* normalized, uint32_t max_length, uint32_t table_log);
+
+private:
+    uint64_t universe;
+
+    // Long-lived coder state, reused across calls. Both work directly on the
+    // caller's buffers.
+    arithmetic_codec encoder;
+    arithmetic_codec decoder;
+    static_data_model length_model;
+};
+// ============================================================================
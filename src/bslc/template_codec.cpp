@@ -0,0 +1,241 @@
+#include <bslc/template_codec.hpp>
+
+#include <bslc/bit_set.hpp>
+#include <bslc/bitmap_coding.hpp>
+#include <bslc/size_bounds.hpp>
+#include <bslc/varint.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+// ============================================================================
+// FastAC limits code buffers to 16 MB
+static size_t const MAX_CODE_BYTES(0x1000000);
+
+static uint8_t const MODE_TEMPLATE(0);
+static uint8_t const MODE_STATIC(1);
+
+static uint32_t const TEMPLATE_BITS(10);
+// Reads go up to three values past the row end
+static uint32_t const ROW_PADDING(3);
+// Rows take 3 bytes per value of buffer, a corrupt header must not make
+// that gigabytes
+static uint64_t const MAX_ROW_WIDTH(1 << 24);
+// ----------------------------------------------------------------------------
+// 0 (1-D), or rows of at most MAX_ROW_WIDTH, at least two of them
+static bool valid_width(uint64_t width, uint64_t universe)
+{
+    return (width <= MAX_ROW_WIDTH) && (width <= universe / 2);
+}
+// ============================================================================
+template_codec::template_codec(uint32_t width, uint64_t universe)
+    : width(width)
+    , universe(universe)
+    , models(size_t(1) << TEMPLATE_BITS)
+{
+    check_universe(universe);
+    if (!valid_width(width, universe)) {
+        throw std::runtime_error("Invalid row width.");
+    }
+}
+// ============================================================================
+size_t template_codec::max_compressed_size(uint32_t match_count) const
+{
+    // Template code is only kept when it fits the static bound
+    return varint_size(universe) + varint_size(width) + 1 + 9
+        + static_bit_model_bound(universe, match_count);
+}
+// ----------------------------------------------------------------------------
+size_t template_codec::decompressed_size(span<uint8_t const> compressed)
+{
+    uint64_t list_universe(0);
+    uint32_t list_width(0);
+    uint8_t mode(0);
+    uint64_t match_count(start_decoder(compressed, list_universe, list_width, mode));
+    decoder.stop_decoder();
+    return static_cast<size_t>(match_count);
+}
+// ============================================================================
+size_t template_codec::compress_into(span<uint32_t const> matches, span<uint8_t> compressed)
+{
+    check_matches(matches, universe);
+
+    size_t offset(0);
+    put_varint(compressed, offset, universe);
+    put_varint(compressed, offset, width);
+    if (offset >= compressed.size()) {
+        throw std::runtime_error("Output buffer too small.");
+    }
+    size_t const mode_offset(offset++);
+
+    // Code straight into the output, the encoder throws when it runs out
+    size_t const code_bytes(std::min(compressed.size() - offset, MAX_CODE_BYTES));
+    if (code_bytes < 3) {
+        throw std::runtime_error("Output buffer too small.");
+    }
+    size_t const template_bytes(std::min(code_bytes, 9 + static_bit_model_bound(universe, matches.size())));
+
+    size_t size(0);
+    try {
+        encoder.set_buffer(static_cast<uint32_t>(template_bytes), compressed.data() + offset);
+        encoder.start_encoder();
+        encoder.put_wide_bits(matches.size(), bit_width(universe));
+        if (width == 0) {
+            code_bits<true>(universe, matches.size(), matches.data(), nullptr);
+        } else {
+            code_rows<true>(width, universe, matches.size(), matches.data(), nullptr);
+        }
+        size = encoder.stop_encoder();
+        compressed[mode_offset] = MODE_TEMPLATE;
+    } catch (std::runtime_error const&) {
+        // Beyond the static bound, the encoder can be restarted
+        encoder.set_buffer(static_cast<uint32_t>(code_bytes), compressed.data() + offset);
+        encoder.start_encoder();
+        encode_static_bitmap(encoder, matches, universe);
+        size = encoder.stop_encoder();
+        compressed[mode_offset] = MODE_STATIC;
+    }
+
+    // Decoder always starts by reading 3 bytes
+    for (; size < 3; ++size) {
+        compressed[offset + size] = 0;
+    }
+    return offset + size;
+}
+// ----------------------------------------------------------------------------
+size_t template_codec::decompress_into(span<uint8_t const> compressed, span<uint32_t> matches)
+{
+    uint64_t list_universe(0);
+    uint32_t list_width(0);
+    uint8_t mode(0);
+    uint64_t match_count(start_decoder(compressed, list_universe, list_width, mode));
+    if (match_count > matches.size()) {
+        decoder.stop_decoder();
+        throw std::runtime_error("Match buffer too small.");
+    }
+
+    uint64_t found(0);
+    if (mode == MODE_STATIC) {
+        found = decode_static_bitmap(decoder, list_universe, match_count, matches.data());
+    } else if (list_width == 0) {
+        found = code_bits<false>(list_universe, match_count, nullptr, matches.data());
+    } else {
+        found = code_rows<false>(list_width, list_universe, match_count, nullptr, matches.data());
+    }
+
+    decoder.stop_decoder();
+    if (found != match_count) {
+        throw std::runtime_error("Corrupted data.");
+    }
+    return static_cast<size_t>(match_count);
+}
+// ============================================================================
+template <bool Encode>
+uint64_t template_codec::code_bits(uint64_t list_universe
+    , uint64_t match_count
+    , uint32_t const* input
+    , uint32_t* output)
+{
+    for (adaptive_bit_model& model : models) {
+        model.reset();
+    }
+
+    uint32_t const mask((1U << TEMPLATE_BITS) - 1);
+    uint32_t context(0);
+    uint64_t found(0);
+    for (uint64_t i(0); (i < list_universe) && (found < match_count); ++i) {
+        uint32_t bit(0);
+        if (Encode) {
+            bit = (input[found] == i);
+            encoder.encode(bit, models[context]);
+        } else {
+            bit = decoder.decode(models[context]);
+            if (bit) {
+                output[found] = static_cast<uint32_t>(i);
+            }
+        }
+        found += bit;
+        context = ((context << 1) | bit) & mask;
+    }
+    return found;
+}
+// ----------------------------------------------------------------------------
+template <bool Encode>
+uint64_t template_codec::code_rows(uint32_t row_width
+    , uint64_t list_universe
+    , uint64_t match_count
+    , uint32_t const* input
+    , uint32_t* output)
+{
+    for (adaptive_bit_model& model : models) {
+        model.reset();
+    }
+
+    size_t const stride(size_t(row_width) + 2 * ROW_PADDING);
+    rows.assign(3 * stride, 0);
+    uint8_t* above_2(rows.data() + ROW_PADDING);
+    uint8_t* above_1(above_2 + stride);
+    uint8_t* current(above_1 + stride);
+
+    uint64_t found(0);
+    for (uint64_t row_start(0); (row_start < list_universe) && (found < match_count); row_start += row_width) {
+        // The row two up is done with, it becomes the current one
+        std::swap(above_2, current);
+        std::swap(above_1, above_2);
+        std::memset(current, 0, row_width);
+
+        // Row - 2 at x - 1 .. x + 1, row - 1 at x - 2 .. x + 2, row at x - 2, x - 1
+        uint32_t line_2((uint32_t(above_2[0]) << 1) | above_2[1]);
+        uint32_t line_1((uint32_t(above_1[0]) << 2) | (uint32_t(above_1[1]) << 1) | above_1[2]);
+        uint32_t line_0(0);
+
+        uint32_t const length(static_cast<uint32_t>(std::min<uint64_t>(row_width, list_universe - row_start)));
+        for (uint32_t x(0); (x < length) && (found < match_count); ++x) {
+            uint32_t const context((line_2 << 7) | (line_1 << 2) | line_0);
+            uint32_t bit(0);
+            if (Encode) {
+                bit = (input[found] == row_start + x);
+                encoder.encode(bit, models[context]);
+            } else {
+                bit = decoder.decode(models[context]);
+                if (bit) {
+                    output[found] = static_cast<uint32_t>(row_start + x);
+                }
+            }
+            found += bit;
+            current[x] = static_cast<uint8_t>(bit);
+
+            // Past the row end the padding reads as zeros
+            line_2 = ((line_2 << 1) | above_2[x + 2]) & 7;
+            line_1 = ((line_1 << 1) | above_1[x + 3]) & 31;
+            line_0 = ((line_0 << 1) | bit) & 3;
+        }
+    }
+    return found;
+}
+// ============================================================================
+uint64_t template_codec::start_decoder(span<uint8_t const> compressed
+    , uint64_t& list_universe
+    , uint32_t& list_width
+    , uint8_t& mode)
+{
+    size_t offset(0);
+    list_universe = get_varint(compressed, offset);
+    check_universe(list_universe);
+    uint64_t const row_width(get_varint(compressed, offset));
+    if (!valid_width(row_width, list_universe)) {
+        throw std::runtime_error("Invalid row width.");
+    }
+    list_width = static_cast<uint32_t>(row_width);
+
+    if (offset >= compressed.size()) {
+        throw std::runtime_error("Truncated header.");
+    }
+    mode = compressed[offset++];
+    if ((mode != MODE_TEMPLATE) && (mode != MODE_STATIC)) {
+        throw std::runtime_error("Invalid coding mode.");
+    }
+
+    return start_bitmap_decoder(decoder, compressed, offset, list_universe);
+}
+// ============================================================================
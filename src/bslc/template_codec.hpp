@@ -0,0 +1,82 @@
+#pragma once
+// ============================================================================
+#include <bslc/codec_base.hpp>
+#include <bslc/match_list.hpp>
+#include <bslc/span.hpp>
+
+#include <fastac/adaptive_bit_model.hpp>
+#include <fastac/arithmetic_codec.hpp>
+
+#include <vector>
+// ============================================================================
+// Bitmap coded JBIG style: each bit with an adaptive_bit_model picked by the
+// 10 bits of a neighbourhood template that are already known.
+//
+// 1-D (width 0): the previous 10 bits. 2-D: the bitmap is read as rows of
+// `width` values (a 1000 x 1000 grid for width 1000) and the template is
+//
+//       . X X X .      row - 2
+//       X X X X X      row - 1
+//       X X ?          current row
+//
+// as in JBIG's three line template. The context is kept in shift registers
+// that take in one new bit of each row per step, so it is never gathered
+// from scratch. Lists the template codes worse than their density fall back
+// to a static model, so the size stays within the static bound.
+//
+// Layout:
+//   varint universe
+//   varint width (0 = 1-D)
+//   byte mode (0 = template, 1 = static)
+//   arithmetic code: match_count (bit width of the universe), bitmap up to
+//   the last match
+class template_codec
+    : public codec_base<template_codec>
+{
+public:
+    // Width of a row for 2-D coding, 0 for 1-D. Rows are at most 2^24 values
+    // and half the universe wide. Universe = number of possible values, at
+    // most MAX_UNIVERSE
+    explicit template_codec(uint32_t width = 0, uint64_t universe = NUM_VALUES);
+
+    size_t max_compressed_size(uint32_t match_count) const;
+    size_t decompressed_size(span<uint8_t const> compressed);
+
+    size_t compress_into(span<uint32_t const> matches, span<uint8_t> compressed);
+    size_t decompress_into(span<uint8_t const> compressed, span<uint32_t> matches);
+
+private:
+    // Code (encoder) or decode (decoder) the bitmap with the template
+    // contexts up to the last of `match_count` ones, return the ones found
+    template <bool Encode>
+    uint64_t code_bits(uint64_t list_universe
+        , uint64_t match_count
+        , uint32_t const* input
+        , uint32_t* output);
+    template <bool Encode>
+    uint64_t code_rows(uint32_t row_width
+        , uint64_t list_universe
+        , uint64_t match_count
+        , uint32_t const* input
+        , uint32_t* output);
+
+    // Reads the header and starts the decoder, returns the match count
+    uint64_t start_decoder(span<uint8_t const> compressed
+        , uint64_t& list_universe
+        , uint32_t& list_width
+        , uint8_t& mode);
+
+private:
+    uint32_t width;
+    uint64_t universe;
+
+    // Long-lived coder state, reused across calls. Both work directly on the
+    // caller's buffers.
+    arithmetic_codec encoder;
+    arithmetic_codec decoder;
+    std::vector<adaptive_bit_model> models;
+    // The two rows above and the current one, a byte per value with zero
+    // padding on either side
+    std::vector<uint8_t> rows;
+};
+// ============================================================================
@@ -0,0 +1,145 @@
+#include <bslc/thread_pool.hpp>
+
+#include <algorithm>
+// ============================================================================
+thread_pool::thread_pool(size_t thread_count)
+    : current_task(nullptr)
+    , generation(0)
+    , busy_count(0)
+    , stopping(false)
+{
+    if (thread_count == 0) {
+        thread_count = std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    queues.reset(new work_queue[thread_count]);
+    for (size_t i(0); i < thread_count; ++i) {
+        queues[i].begin = queues[i].end = 0;
+    }
+
+    threads.reserve(thread_count);
+    for (size_t i(0); i < thread_count; ++i) {
+        threads.emplace_back(&thread_pool::worker_loop, this, i);
+    }
+}
+// ----------------------------------------------------------------------------
+thread_pool::~thread_pool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    start_cv.notify_all();
+
+    for (auto& t : threads) {
+        t.join();
+    }
+}
+// ============================================================================
+void thread_pool::run(size_t task_count, task_t const& task)
+{
+    if (task_count == 0) {
+        return;
+    }
+
+    size_t const worker_count(threads.size());
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        // Initial even split, stealing evens out the rest
+        for (size_t i(0); i < worker_count; ++i) {
+            std::lock_guard<std::mutex> queue_lock(queues[i].mutex);
+            queues[i].begin = task_count * i / worker_count;
+            queues[i].end = task_count * (i + 1) / worker_count;
+        }
+
+        current_task = &task;
+        error = nullptr;
+        busy_count = worker_count;
+        ++generation;
+        start_cv.notify_all();
+
+        done_cv.wait(lock, [this] { return busy_count == 0; });
+        current_task = nullptr;
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+// ============================================================================
+void thread_pool::worker_loop(size_t worker)
+{
+    size_t seen_generation(0);
+    for (;;) {
+        task_t const* task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            start_cv.wait(lock, [&] { return stopping || (generation != seen_generation); });
+            if (stopping) {
+                return;
+            }
+            seen_generation = generation;
+            task = current_task;
+        }
+
+        size_t index;
+        while (pop_task(worker, index) || (steal_tasks(worker) && pop_task(worker, index))) {
+            try {
+                (*task)(worker, index);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--busy_count == 0) {
+                done_cv.notify_all();
+            }
+        }
+    }
+}
+// ----------------------------------------------------------------------------
+bool thread_pool::pop_task(size_t worker, size_t& task)
+{
+    work_queue& q(queues[worker]);
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (q.begin == q.end) {
+        return false;
+    }
+    task = q.begin++;
+    return true;
+}
+// ----------------------------------------------------------------------------
+bool thread_pool::steal_tasks(size_t worker)
+{
+    size_t const worker_count(threads.size());
+    for (size_t i(1); i < worker_count; ++i) {
+        work_queue& victim(queues[(worker + i) % worker_count]);
+
+        size_t begin, end;
+        {
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            size_t remaining(victim.end - victim.begin);
+            if (remaining == 0) {
+                continue;
+            }
+            // Take the back half, leave the victim the front
+            begin = victim.end - (remaining + 1) / 2;
+            end = victim.end;
+            victim.end = begin;
+        }
+
+        work_queue& own(queues[worker]);
+        std::lock_guard<std::mutex> lock(own.mutex);
+        own.begin = begin;
+        own.end = end;
+        return true;
+    }
+    return false;
+}
+// ============================================================================
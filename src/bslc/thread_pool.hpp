@@ -0,0 +1,68 @@
+#pragma once
+// ============================================================================
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+// ============================================================================
+// Fixed set of long-lived worker threads executing indexed tasks.
+//
+// Each worker starts with a contiguous slice of the task range and, once it
+// runs dry, steals half of the remaining slice of another worker. Tasks get
+// the index of the executing worker, so callers can keep per-worker state
+// (codecs, scratch buffers) without any locking.
+class thread_pool
+{
+public:
+    typedef std::function<void(size_t worker, size_t task)> task_t;
+
+    // 0 = one worker per hardware thread
+    explicit thread_pool(size_t thread_count = 0);
+    ~thread_pool();
+
+    thread_pool(thread_pool const&) = delete;
+    thread_pool& operator=(thread_pool const&) = delete;
+
+    size_t size() const;
+
+    // Runs task(worker, i) for all i in [0, task_count) and waits for completion.
+    // The first exception thrown by a task is rethrown here.
+    // NB: Not reentrant -- must not be called from within a task
+    void run(size_t task_count, task_t const& task);
+
+private:
+    // Slice of the task range owned by one worker
+    struct alignas(64) work_queue
+    {
+        std::mutex mutex;
+        size_t begin;
+        size_t end;
+    };
+
+    void worker_loop(size_t worker);
+    bool pop_task(size_t worker, size_t& task);
+    bool steal_tasks(size_t worker);
+
+private:
+    std::vector<std::thread> threads;
+    std::unique_ptr<work_queue[]> queues;
+
+    std::mutex mutex;
+    std::condition_variable start_cv;
+    std::condition_variable done_cv;
+    task_t const* current_task;
+    std::exception_ptr error;
+    size_t generation;
+    size_t busy_count;
+    bool stopping;
+};
+// ============================================================================
+inline size_t thread_pool::size() const
+{
+    return threads.size();
+}
+// ============================================================================
@@ -0,0 +1,116 @@
+#include <bslc/trained_gap_codec.hpp>
+
+#include <bslc/gap_coding.hpp>
+#include <bslc/varint.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+// ============================================================================
+// FastAC limits code buffers to 16 MB
+static size_t const MAX_CODE_BYTES(0x1000000);
+// ============================================================================
+trained_gap_codec::trained_gap_codec(gap_models const& models)
+    : models(models)
+    , universe(models.universe())
+{
+    check_universe(universe);
+}
+// ============================================================================
+size_t trained_gap_codec::max_compressed_size(uint32_t match_count) const
+{
+    // Lengths cost at most ~12 bits (every weight >= 1 of ~2^12), mantissas
+    // at most 32 bits
+    return varint_size(models.id()) + size_t(match_count) * 6 + 16;
+}
+// ----------------------------------------------------------------------------
+size_t trained_gap_codec::decompressed_size(span<uint8_t const> compressed)
+{
+    uint64_t const match_count(start_decoder(compressed));
+    decoder.stop_decoder();
+    return static_cast<size_t>(match_count);
+}
+// ============================================================================
+size_t trained_gap_codec::compress_into(span<uint32_t const> matches, span<uint8_t> compressed)
+{
+    check_matches(matches, universe);
+
+    size_t offset(0);
+    put_varint(compressed, offset, models.id());
+
+    // Code straight into the output, the encoder throws when it runs out
+    size_t const code_bytes(std::min(compressed.size() - offset, MAX_CODE_BYTES));
+    if (code_bytes < 3) {
+        throw std::runtime_error("Output buffer too small.");
+    }
+    encoder.set_buffer(static_cast<uint32_t>(code_bytes), compressed.data() + offset);
+    encoder.start_encoder();
+
+    encode_gap(encoder, models.count_model(), matches.size());
+    if (!matches.empty()) {
+        static_data_model& length_model(models.model(gap_density_class(universe, matches.size())));
+        uint64_t next(0);
+        for (uint32_t match : matches) {
+            encode_gap(encoder, length_model, match - next);
+            next = uint64_t(match) + 1;
+        }
+    }
+
+    return offset + encoder.stop_encoder_trimmed();
+}
+// ----------------------------------------------------------------------------
+size_t trained_gap_codec::decompress_into(span<uint8_t const> compressed, span<uint32_t> matches)
+{
+    uint64_t const match_count(start_decoder(compressed));
+    if (match_count > matches.size()) {
+        decoder.stop_decoder();
+        throw std::runtime_error("Match buffer too small.");
+    }
+
+    if (match_count != 0) {
+        static_data_model& length_model(models.model(gap_density_class(universe, match_count)));
+        uint64_t next(0);
+        for (uint64_t i(0); i < match_count; ++i) {
+            uint64_t const gap(decode_gap(decoder, length_model));
+            if (next + gap >= universe) {
+                decoder.stop_decoder();
+                throw std::runtime_error("Match out of range.");
+            }
+            matches[i] = static_cast<uint32_t>(next + gap);
+            next += gap + 1;
+        }
+    }
+
+    decoder.stop_decoder();
+    return static_cast<size_t>(match_count);
+}
+// ============================================================================
+uint64_t trained_gap_codec::start_decoder(span<uint8_t const> compressed)
+{
+    size_t offset(0);
+    if (get_varint(compressed, offset) != models.id()) {
+        throw std::runtime_error("List was coded with another model file.");
+    }
+
+    // Trailing zeros of the code are left out, the decoder reads them past
+    // its end. A code of less than the 3 bytes FastAC takes is copied out
+    size_t const code_bytes(std::min(compressed.size() - offset, MAX_CODE_BYTES));
+    if (code_bytes < sizeof(short_code)) {
+        std::memset(short_code, 0, sizeof(short_code));
+        std::copy(compressed.begin() + offset, compressed.end(), short_code);
+        decoder.set_buffer(sizeof(short_code), short_code);
+    } else {
+        // Decoder only reads from the buffer
+        decoder.set_buffer(static_cast<uint32_t>(code_bytes)
+            , const_cast<uint8_t*>(compressed.data() + offset));
+    }
+    decoder.start_decoder();
+
+    uint64_t const match_count(decode_gap(decoder, models.count_model()));
+    if (match_count > universe) {
+        decoder.stop_decoder();
+        throw std::runtime_error("Invalid match count.");
+    }
+    return match_count;
+}
+// ============================================================================
@@ -0,0 +1,53 @@
+#pragma once
+// ============================================================================
+#include <bslc/codec_base.hpp>
+#include <bslc/gap_models.hpp>
+#include <bslc/match_list.hpp>
+#include <bslc/span.hpp>
+
+#include <fastac/arithmetic_codec.hpp>
+// ============================================================================
+// Gaps coded as in gap_codec, the bit lengths with the trained model of the
+// list's density class from a shared gap_models file, the match count with
+// its trained count model. Nothing is learned or stored per list, the
+// universe is the one of the model file, and the code ends on the fewest
+// bytes that decode, so lists of a few hundred matches and less cost close
+// to their entropy under the trained models. Decoding needs the same model
+// file, checked by its ID.
+//
+// The code runs to the end of the compressed list with its trailing zeros
+// left out: a list must be decoded from a span that ends where it ends.
+//
+// Layout:
+//   varint model id
+//   arithmetic code: match_count (bit length, mantissa), match_count x (gap
+//   bit length, gap mantissa)
+class trained_gap_codec
+    : public codec_base<trained_gap_codec>
+{
+public:
+    // `models` must outlive the codec, lists are of its universe
+    explicit trained_gap_codec(gap_models const& models);
+
+    size_t max_compressed_size(uint32_t match_count) const;
+    size_t decompressed_size(span<uint8_t const> compressed);
+
+    size_t compress_into(span<uint32_t const> matches, span<uint8_t> compressed);
+    size_t decompress_into(span<uint8_t const> compressed, span<uint32_t> matches);
+
+private:
+    // Reads the model ID and starts the decoder, returns the match count
+    uint64_t start_decoder(span<uint8_t const> compressed);
+
+private:
+    gap_models const& models;
+    uint64_t universe;
+
+    // Long-lived coder state, reused across calls. Both work directly on the
+    // caller's buffers.
+    arithmetic_codec encoder;
+    arithmetic_codec decoder;
+    // Zero padded copy of a code too short for FastAC
+    uint8_t short_code[3];
+};
+// ============================================================================
@@ -0,0 +1,58 @@
+#pragma once
+// ============================================================================
+#include <bslc/match_list.hpp>
+#include <bslc/span.hpp>
+
+#include <cstdint>
+#include <stdexcept>
+// ============================================================================
+// LEB128 style variable length integers: 7 bits per byte, MSB = continuation
+inline size_t varint_size(uint64_t value)
+{
+    size_t size(1);
+    while (value >= 0x80) {
+        value >>= 7;
+        ++size;
+    }
+    return size;
+}
+// ----------------------------------------------------------------------------
+inline void put_varint(buffer_t& buffer, uint64_t value)
+{
+    while (value >= 0x80) {
+        buffer.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    buffer.push_back(static_cast<uint8_t>(value));
+}
+// ----------------------------------------------------------------------------
+// Writes a varint at `offset` and advances it past the value
+inline void put_varint(span<uint8_t> buffer, size_t& offset, uint64_t value)
+{
+    if (offset + varint_size(value) > buffer.size()) {
+        throw std::runtime_error("Output buffer too small.");
+    }
+    while (value >= 0x80) {
+        buffer[offset++] = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    buffer[offset++] = static_cast<uint8_t>(value);
+}
+// ----------------------------------------------------------------------------
+// Reads a varint at `offset` and advances it past the value
+inline uint64_t get_varint(span<uint8_t const> buffer, size_t& offset)
+{
+    uint64_t value(0);
+    for (uint32_t shift(0); shift < 64; shift += 7) {
+        if (offset >= buffer.size()) {
+            throw std::runtime_error("Truncated varint.");
+        }
+        uint8_t byte(buffer[offset++]);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return value;
+        }
+    }
+    throw std::runtime_error("Invalid varint.");
+}
+// ============================================================================
@@ -0,0 +1,413 @@
+#include <bslc/workload.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+// ============================================================================
+static char const* const WORKLOAD_NAMES[WORKLOAD_KIND_COUNT] = {
+    "uniform", "clustered", "bursty", "periodic", "zipf"
+};
+// ----------------------------------------------------------------------------
+char const* workload_name(workload_kind kind)
+{
+    return WORKLOAD_NAMES[static_cast<uint32_t>(kind)];
+}
+// ----------------------------------------------------------------------------
+workload_kind parse_workload_kind(std::string const& name)
+{
+    for (uint32_t i(0); i < WORKLOAD_KIND_COUNT; ++i) {
+        if (name == WORKLOAD_NAMES[i]) {
+            return static_cast<workload_kind>(i);
+        }
+    }
+    throw std::runtime_error("Unknown workload: " + name);
+}
+// ----------------------------------------------------------------------------
+std::vector<uint32_t> gen_test_sizes()
+{
+    std::vector<uint32_t> result;
+    for (uint32_t n(0); n < 100; n += 1) {
+        result.push_back(n);
+    }
+    for (uint32_t n(100); n < 500; n += 10) {
+        result.push_back(n);
+    }
+    for (uint32_t n(500); n < 3000; n += 100) {
+        result.push_back(n);
+    }
+    for (uint32_t n(3000); n < 15000; n += 1000) {
+        result.push_back(n);
+    }
+    for (uint32_t n(15000); n < 50000; n += 5000) {
+        result.push_back(n);
+    }
+    for (uint32_t n(50000); n <= 500000; n += 50000) {
+        result.push_back(n);
+    }
+    return result;
+}
+// ============================================================================
+static uint64_t rotate_left(uint64_t x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+// ----------------------------------------------------------------------------
+static uint64_t splitmix64(uint64_t& x)
+{
+    uint64_t z(x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+// ============================================================================
+workload_generator::workload_generator(uint64_t seed)
+{
+    this->seed(seed);
+}
+// ----------------------------------------------------------------------------
+void workload_generator::seed(uint64_t value)
+{
+    for (uint64_t& s : state) {
+        s = splitmix64(value);
+    }
+}
+// ============================================================================
+match_list_t workload_generator::generate(workload_kind kind, uint64_t universe, uint32_t match_count)
+{
+    switch (kind) {
+    case workload_kind::clustered: return clustered(universe, match_count);
+    case workload_kind::bursty: return bursty(universe, match_count);
+    case workload_kind::periodic: return periodic(universe, match_count);
+    case workload_kind::zipf: return zipf(universe, match_count);
+    default: return uniform(universe, match_count);
+    }
+}
+// ----------------------------------------------------------------------------
+match_list_t workload_generator::uniform(uint64_t universe, uint32_t match_count)
+{
+    check_arguments(universe, match_count);
+
+    match_list_t result;
+    result.reserve(match_count);
+    sample(0, universe, match_count, result);
+    return result;
+}
+// ----------------------------------------------------------------------------
+match_list_t workload_generator::clustered(uint64_t universe
+    , uint32_t match_count
+    , uint32_t cluster_count
+    , double density)
+{
+    check_arguments(universe, match_count);
+    if (!(density > 0.0) || (density > 1.0)) {
+        throw std::runtime_error("Density must be in (0, 1].");
+    }
+
+    match_list_t result;
+    if (match_count == 0) {
+        return result;
+    }
+    result.reserve(match_count);
+    cluster_count = std::max(1U, std::min(cluster_count, match_count));
+
+    // Split the matches among the clusters at random cut points
+    std::vector<uint64_t> sizes(cluster_count + 1);
+    sizes[0] = 0;
+    for (uint32_t i(1); i < cluster_count; ++i) {
+        sizes[i] = next_below(uint64_t(match_count) + 1);
+    }
+    sizes[cluster_count] = match_count;
+    std::sort(sizes.begin(), sizes.end());
+    for (uint32_t i(0); i < cluster_count; ++i) {
+        sizes[i] = sizes[i + 1] - sizes[i];
+    }
+    sizes.pop_back();
+
+    std::vector<uint64_t> widths(cluster_count);
+    uint64_t total_width(0);
+    for (uint32_t i(0); i < cluster_count; ++i) {
+        widths[i] = static_cast<uint64_t>(std::ceil(double(sizes[i]) / density));
+        total_width += widths[i];
+    }
+    // Too dense for the universe, share out the free positions instead
+    if (total_width > universe) {
+        total_width = 0;
+        for (uint32_t i(0); i < cluster_count; ++i) {
+            widths[i] = sizes[i] + sizes[i] * (universe - match_count) / match_count;
+            total_width += widths[i];
+        }
+    }
+
+    // Place the windows in order, with random space in between
+    std::vector<uint64_t> offsets(cluster_count);
+    for (uint64_t& offset : offsets) {
+        offset = next_below(universe - total_width + 1);
+    }
+    std::sort(offsets.begin(), offsets.end());
+
+    uint64_t first(0);
+    for (uint32_t i(0); i < cluster_count; ++i) {
+        sample(offsets[i] + first, widths[i], static_cast<uint32_t>(sizes[i]), result);
+        first += widths[i];
+    }
+    return result;
+}
+// ----------------------------------------------------------------------------
+match_list_t workload_generator::bursty(uint64_t universe
+    , uint32_t match_count
+    , double mean_burst
+    , double burst_gap)
+{
+    check_arguments(universe, match_count);
+    if ((mean_burst < 1.0) || (burst_gap < 1.0)) {
+        throw std::runtime_error("Burst length and gap must be at least 1.");
+    }
+
+    // Spend whatever the bursts leave of the universe on the pauses
+    double const burst_count(std::max(1.0, match_count / mean_burst));
+    double const pause_gap(std::max(1.0, (double(universe) - match_count * burst_gap) / burst_count));
+
+    std::vector<uint64_t> gaps(size_t(match_count) + 1);
+    bool in_burst(false);
+    for (uint64_t& gap : gaps) {
+        if (in_burst) {
+            gap = 1 + next_geometric(burst_gap);
+            in_burst = (next_double() * mean_burst >= 1.0);
+        } else {
+            gap = 1 + next_geometric(pause_gap);
+            in_burst = true;
+        }
+    }
+    return fit_gaps(gaps, universe);
+}
+// ----------------------------------------------------------------------------
+match_list_t workload_generator::periodic(uint64_t universe, uint32_t match_count, double jitter)
+{
+    check_arguments(universe, match_count);
+    if ((jitter < 0.0) || (jitter > 1.0)) {
+        throw std::runtime_error("Jitter must be in [0, 1].");
+    }
+
+    double const period(double(universe) / (double(match_count) + 1));
+
+    std::vector<uint64_t> gaps(size_t(match_count) + 1);
+    for (uint64_t& gap : gaps) {
+        double const length(period * (1.0 + jitter * (2.0 * next_double() - 1.0)));
+        gap = std::max(uint64_t(1), static_cast<uint64_t>(std::llround(length)));
+    }
+    return fit_gaps(gaps, universe);
+}
+// ----------------------------------------------------------------------------
+match_list_t workload_generator::zipf(uint64_t universe, uint32_t match_count, double exponent)
+{
+    check_arguments(universe, match_count);
+    if (exponent <= 0.0) {
+        throw std::runtime_error("Exponent must be positive.");
+    }
+
+    // Inverse CDF of the power law on [1, universe]
+    double const largest(static_cast<double>(universe));
+    double const one_minus_s(1.0 - exponent);
+
+    std::vector<uint64_t> gaps(size_t(match_count) + 1);
+    for (uint64_t& gap : gaps) {
+        double const u(next_double());
+        double length;
+        if (std::fabs(one_minus_s) < 1e-9) {
+            length = std::pow(largest, u);
+        } else {
+            length = std::pow((std::pow(largest, one_minus_s) - 1.0) * u + 1.0, 1.0 / one_minus_s);
+        }
+        gap = std::max(uint64_t(1), static_cast<uint64_t>(length));
+    }
+    return fit_gaps(gaps, universe);
+}
+// ============================================================================
+uint64_t workload_generator::next()
+{
+    // xoshiro256**
+    uint64_t const result(rotate_left(state[1] * 5, 7) * 9);
+    uint64_t const t(state[1] << 17);
+
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = rotate_left(state[3], 45);
+
+    return result;
+}
+// ----------------------------------------------------------------------------
+double workload_generator::next_double()
+{
+    return (double(next() >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+// ----------------------------------------------------------------------------
+uint64_t workload_generator::next_below(uint64_t bound)
+{
+    // Reject the low values that would make the modulo biased
+    uint64_t const threshold((0 - bound) % bound);
+    for (;;) {
+        uint64_t const r(next());
+        if (r >= threshold) {
+            return r % bound;
+        }
+    }
+}
+// ----------------------------------------------------------------------------
+uint64_t workload_generator::next_geometric(double mean)
+{
+    if (mean <= 1.0) {
+        return 0;
+    }
+    return static_cast<uint64_t>(std::log(next_double()) / std::log(1.0 - 1.0 / mean));
+}
+// ============================================================================
+void workload_generator::sample(uint64_t first, uint64_t range, uint32_t count, match_list_t& output)
+{
+    // J. S. Vitter, "An efficient algorithm for sequential random sampling",
+    // ACM TOMS 13(1), 1987. Draws the number of skipped values between
+    // selections directly; falls back to method A once the sample is dense.
+    double const ALPHA_INV(13.0);
+
+    uint64_t remaining(range);
+    uint64_t n(count);
+    uint64_t current(first);
+    double threshold(ALPHA_INV * double(n));
+
+    if ((n > 1) && (threshold < double(remaining))) {
+        double ninv(1.0 / double(n));
+        double vprime(std::exp(std::log(next_double()) * ninv));
+        uint64_t qu1(remaining - n + 1);
+
+        while ((n > 1) && (threshold < double(remaining))) {
+            double const real_remaining(static_cast<double>(remaining));
+            double const real_qu1(static_cast<double>(qu1));
+            double const nmin1inv(1.0 / double(n - 1));
+
+            uint64_t skip(0);
+            for (;;) {
+                double x;
+                for (;;) {
+                    x = real_remaining * (1.0 - vprime);
+                    skip = static_cast<uint64_t>(x);
+                    if (skip < qu1) {
+                        break;
+                    }
+                    vprime = std::exp(std::log(next_double()) * ninv);
+                }
+
+                double const u(next_double());
+                double const real_skip(static_cast<double>(skip));
+                double const y1(std::exp(std::log(u * real_remaining / real_qu1) * nmin1inv));
+                vprime = y1 * (1.0 - x / real_remaining) * (real_qu1 / (real_qu1 - real_skip));
+                if (vprime <= 1.0) {
+                    break;
+                }
+
+                double y2(1.0);
+                double top(real_remaining - 1.0);
+                double bottom;
+                uint64_t limit;
+                if (n - 1 > skip) {
+                    bottom = real_remaining - double(n);
+                    limit = remaining - skip;
+                } else {
+                    bottom = real_remaining - real_skip - 1.0;
+                    limit = qu1;
+                }
+                for (uint64_t t(remaining - 1); t >= limit; --t) {
+                    y2 = (y2 * top) / bottom;
+                    top -= 1.0;
+                    bottom -= 1.0;
+                }
+                if (real_remaining / (real_remaining - x) >= y1 * std::exp(std::log(y2) * nmin1inv)) {
+                    vprime = std::exp(std::log(next_double()) * nmin1inv);
+                    break;
+                }
+                vprime = std::exp(std::log(next_double()) * ninv);
+            }
+
+            current += skip;
+            output.push_back(static_cast<uint32_t>(current++));
+
+            remaining -= skip + 1;
+            --n;
+            ninv = nmin1inv;
+            qu1 -= skip;
+            threshold -= ALPHA_INV;
+        }
+
+        if (n == 1) {
+            current += static_cast<uint64_t>(double(remaining) * vprime);
+            output.push_back(static_cast<uint32_t>(current));
+            return;
+        }
+    }
+
+    sample_small(current, remaining, static_cast<uint32_t>(n), output);
+}
+// ----------------------------------------------------------------------------
+void workload_generator::sample_small(uint64_t first, uint64_t range, uint32_t count, match_list_t& output)
+{
+    // Vitter's method A, linear in the range
+    double top(double(range - count));
+    double real_range(static_cast<double>(range));
+    uint64_t current(first);
+
+    for (; count >= 2; --count) {
+        double const v(next_double());
+        double quotient(top / real_range);
+        while (quotient > v) {
+            ++current;
+            top -= 1.0;
+            real_range -= 1.0;
+            quotient = quotient * top / real_range;
+        }
+        output.push_back(static_cast<uint32_t>(current++));
+        real_range -= 1.0;
+    }
+
+    if (count == 1) {
+        current += static_cast<uint64_t>(real_range * next_double());
+        output.push_back(static_cast<uint32_t>(current));
+    }
+}
+// ============================================================================
+match_list_t workload_generator::fit_gaps(std::vector<uint64_t> const& gaps, uint64_t universe)
+{
+    // Matches take one position each, scale the space between them so that
+    // the gaps (one more than the matches) add up to the universe
+    size_t const match_count(gaps.size() - 1);
+    uint64_t const free_positions(universe - match_count);
+
+    uint64_t total_extra(0);
+    for (uint64_t gap : gaps) {
+        total_extra += gap - 1;
+    }
+    // All gaps 1: spread evenly
+    bool const even(total_extra == 0);
+    if (even) {
+        total_extra = gaps.size();
+    }
+    double const scale(double(free_positions) / double(total_extra));
+
+    match_list_t result(match_count);
+    uint64_t extra(0);
+    for (size_t i(0); i < match_count; ++i) {
+        extra += even ? 1 : gaps[i] - 1;
+        uint64_t const shift(std::min(free_positions, static_cast<uint64_t>(double(extra) * scale)));
+        result[i] = static_cast<uint32_t>(i + shift);
+    }
+    return result;
+}
+// ----------------------------------------------------------------------------
+void workload_generator::check_arguments(uint64_t universe, uint32_t match_count)
+{
+    check_universe(universe);
+    if (match_count > universe) {
+        throw std::runtime_error("Match count exceeds the universe.");
+    }
+}
+// ============================================================================
@@ -0,0 +1,85 @@
+#pragma once
+// ============================================================================
+#include <bslc/match_list.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+// ============================================================================
+enum class workload_kind : uint8_t
+{
+    uniform,    // every subset equally likely
+    clustered,  // dense windows at random places
+    bursty,     // two state Markov chain: runs of close matches, long pauses
+    periodic,   // roughly evenly spaced, jittered
+    zipf,       // power law gaps: mostly tiny, now and then huge
+};
+
+static uint32_t const WORKLOAD_KIND_COUNT(5);
+
+char const* workload_name(workload_kind kind);
+// Throws on unknown names
+workload_kind parse_workload_kind(std::string const& name);
+
+// Match counts the codecs are evaluated at, 0 ... 500000
+std::vector<uint32_t> gen_test_sizes();
+// ============================================================================
+// Seeded synthetic match lists, all sorted, distinct and below the universe.
+//
+// Runs in O(match_count) whatever the universe. The same seed produces the
+// same lists on every platform: the generator brings its own random source
+// (xoshiro256**) instead of the implementation defined std:: distributions.
+//
+// The gap based workloads (bursty, periodic, zipf) draw gaps whose expected
+// total is the universe, then scale them to fit it exactly.
+class workload_generator
+{
+public:
+    explicit workload_generator(uint64_t seed = 0);
+
+    void seed(uint64_t value);
+
+    // Default parameters of each kind
+    match_list_t generate(workload_kind kind, uint64_t universe, uint32_t match_count);
+
+    // Vitter's sequential sampling (method D), no sorting or lookups
+    match_list_t uniform(uint64_t universe, uint32_t match_count);
+    // `density` = matches per position within a cluster
+    match_list_t clustered(uint64_t universe
+        , uint32_t match_count
+        , uint32_t cluster_count = 64
+        , double density = 0.25);
+    // Bursts of `mean_burst` matches on average, one per `burst_gap`
+    // positions on average
+    match_list_t bursty(uint64_t universe
+        , uint32_t match_count
+        , double mean_burst = 32.0
+        , double burst_gap = 2.0);
+    // Gaps vary by up to +-`jitter` of the period
+    match_list_t periodic(uint64_t universe, uint32_t match_count, double jitter = 0.1);
+    // P(gap = g) ~ g^-exponent
+    match_list_t zipf(uint64_t universe, uint32_t match_count, double exponent = 1.5);
+
+private:
+    uint64_t next();
+    // Uniform in (0, 1)
+    double next_double();
+    // Uniform in [0, bound)
+    uint64_t next_below(uint64_t bound);
+    // Failures before the first success, success probability 1 / mean
+    uint64_t next_geometric(double mean);
+
+    // Appends `count` sorted values from [first, first + range)
+    void sample(uint64_t first, uint64_t range, uint32_t count, match_list_t& output);
+    void sample_small(uint64_t first, uint64_t range, uint32_t count, match_list_t& output);
+
+    // Turns gaps (>= 1, first one counted from -1) into matches spanning
+    // the universe
+    match_list_t fit_gaps(std::vector<uint64_t> const& gaps, uint64_t universe);
+
+    static void check_arguments(uint64_t universe, uint32_t match_count);
+
+private:
+    uint64_t state[4];
+};
+// ============================================================================
@@ -0,0 +1,157 @@
+#include <bslc/zlib_codec.hpp>
+
+#include <bslc/varint.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+// ============================================================================
+static voidpf arena_alloc(voidpf opaque, uInt items, uInt size)
+{
+    return static_cast<arena*>(opaque)->allocate(size_t(items) * size);
+}
+// ----------------------------------------------------------------------------
+static void arena_free(voidpf, voidpf)
+{
+    // Released with the arena
+}
+// ----------------------------------------------------------------------------
+static void init_stream(z_stream& stream, arena& memory)
+{
+    stream.zalloc = arena_alloc;
+    stream.zfree = arena_free;
+    stream.opaque = &memory;
+    stream.next_in = nullptr;
+    stream.avail_in = 0;
+}
+// ============================================================================
+zlib_codec::zlib_codec(uint32_t bits_per_symbol, uint64_t universe)
+    : bits_per_symbol(bits_per_symbol)
+    , universe(universe)
+    , chunk(BITMAP_CHUNK_SIZE)
+{
+    check_universe(universe);
+
+    init_stream(deflate_stream, memory);
+    if (deflateInit(&deflate_stream, Z_BEST_COMPRESSION) != Z_OK) {
+        throw std::runtime_error("Compression error.");
+    }
+
+    init_stream(inflate_stream, memory);
+    if (inflateInit(&inflate_stream) != Z_OK) {
+        deflateEnd(&deflate_stream);
+        throw std::runtime_error("Decompression error.");
+    }
+}
+// ----------------------------------------------------------------------------
+zlib_codec::~zlib_codec()
+{
+    deflateEnd(&deflate_stream);
+    inflateEnd(&inflate_stream);
+}
+// ============================================================================
+size_t zlib_codec::max_compressed_size(uint32_t match_count) const
+{
+    size_t size(symbol_count(static_cast<uint8_t>(bits_per_symbol), universe));
+    return varint_size(universe) + varint_size(match_count) + compressBound(static_cast<uLong>(size));
+}
+// ----------------------------------------------------------------------------
+size_t zlib_codec::decompressed_size(span<uint8_t const> compressed)
+{
+    size_t offset(0);
+    check_universe(get_varint(compressed, offset));
+    return static_cast<size_t>(get_varint(compressed, offset));
+}
+// ============================================================================
+size_t zlib_codec::compress_into(span<uint32_t const> matches, span<uint8_t> compressed)
+{
+    check_matches(matches, universe);
+
+    size_t offset(0);
+    put_varint(compressed, offset, universe);
+    put_varint(compressed, offset, matches.size());
+
+    deflateReset(&deflate_stream);
+    deflate_stream.avail_out = static_cast<uInt>(compressed.size() - offset);
+    deflate_stream.next_out = compressed.data() + offset;
+
+    // Generate the bitmap a chunk at a time and stream it through deflate
+    size_t const total(symbol_count(static_cast<uint8_t>(bits_per_symbol), universe));
+    size_t consumed(0);
+    for (size_t first(0); first < total; first += BITMAP_CHUNK_SIZE) {
+        size_t size(std::min(BITMAP_CHUNK_SIZE, total - first));
+        consumed += make_symbols(matches.subspan(consumed)
+            , static_cast<uint8_t>(bits_per_symbol)
+            , first
+            , span<uint8_t>(chunk.data(), size));
+
+        bool const last(first + size == total);
+        deflate_stream.avail_in = static_cast<uInt>(size);
+        deflate_stream.next_in = chunk.data();
+
+        int err = deflate(&deflate_stream, last ? Z_FINISH : Z_NO_FLUSH);
+        if ((last && (err != Z_STREAM_END)) || (deflate_stream.avail_in > 0)) {
+            throw std::runtime_error("Output buffer too small.");
+        }
+    }
+    if (consumed != matches.size()) {
+        throw std::runtime_error("Match out of range.");
+    }
+
+    return offset + deflate_stream.total_out;
+}
+// ----------------------------------------------------------------------------
+size_t zlib_codec::decompress_into(span<uint8_t const> compressed, span<uint32_t> matches)
+{
+    size_t offset(0);
+    uint64_t const list_universe(get_varint(compressed, offset));
+    check_universe(list_universe);
+    uint64_t match_count(get_varint(compressed, offset));
+    if (match_count > list_universe) {
+        throw std::runtime_error("Invalid match count.");
+    }
+    if (match_count > matches.size()) {
+        throw std::runtime_error("Match buffer too small.");
+    }
+
+    inflateReset(&inflate_stream);
+    inflate_stream.avail_in = static_cast<uInt>(compressed.size() - offset);
+    inflate_stream.next_in = const_cast<Bytef*>(compressed.data() + offset);
+
+    // Inflate a chunk at a time, extracting the matches as we go
+    size_t const total(symbol_count(static_cast<uint8_t>(bits_per_symbol), list_universe));
+    size_t count(0);
+    int err(Z_OK);
+    for (size_t first(0); first < total; first += BITMAP_CHUNK_SIZE) {
+        size_t size(std::min(BITMAP_CHUNK_SIZE, total - first));
+        inflate_stream.avail_out = static_cast<uInt>(size);
+        inflate_stream.next_out = chunk.data();
+
+        err = inflate(&inflate_stream, Z_NO_FLUSH);
+        if (((err != Z_OK) && (err != Z_STREAM_END)) || (inflate_stream.avail_out > 0)) {
+            throw std::runtime_error("Decompression error.");
+        }
+
+        count = make_matches(span<uint8_t const>(chunk.data(), size)
+            , static_cast<uint8_t>(bits_per_symbol)
+            , first
+            , matches.first(static_cast<size_t>(match_count))
+            , count);
+    }
+
+    // The end of stream marker may still be pending when the bitmap fills
+    // the last chunk exactly
+    if (err != Z_STREAM_END) {
+        uint8_t extra(0);
+        inflate_stream.avail_out = 1;
+        inflate_stream.next_out = &extra;
+        if ((inflate(&inflate_stream, Z_FINISH) != Z_STREAM_END) || (inflate_stream.avail_out == 0)) {
+            throw std::runtime_error("Decompression error.");
+        }
+    }
+
+    if (count != match_count) {
+        throw std::runtime_error("Size mismatch.");
+    }
+    return count;
+}
+// ============================================================================
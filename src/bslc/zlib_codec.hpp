@@ -0,0 +1,51 @@
+#pragma once
+// ============================================================================
+#include <bslc/arena.hpp>
+#include <bslc/codec_base.hpp>
+#include <bslc/match_list.hpp>
+#include <bslc/span.hpp>
+
+#include <zlib.h>
+// ============================================================================
+// Bitmap with `bits_per_symbol` values per byte, deflated with zlib
+//
+// Layout:
+//   varint universe
+//   varint match_count
+//   compressed bitmap
+//
+// The bitmap is never materialized: it is generated and consumed in
+// BITMAP_CHUNK_SIZE slices that stream through the library.
+//
+// The deflate and inflate streams live as long as the codec and are only
+// reset between lists. Their state comes from a private arena, so after the
+// first list no call touches the heap.
+class zlib_codec
+    : public codec_base<zlib_codec>
+{
+public:
+    // Universe = number of possible values, at most MAX_UNIVERSE
+    explicit zlib_codec(uint32_t bits_per_symbol, uint64_t universe = NUM_VALUES);
+    ~zlib_codec();
+
+    // Streams point back into the codec
+    zlib_codec(zlib_codec const&) = delete;
+    zlib_codec& operator=(zlib_codec const&) = delete;
+
+    size_t max_compressed_size(uint32_t match_count) const;
+    size_t decompressed_size(span<uint8_t const> compressed);
+
+    size_t compress_into(span<uint32_t const> matches, span<uint8_t> compressed);
+    size_t decompress_into(span<uint8_t const> compressed, span<uint32_t> matches);
+
+private:
+    uint32_t bits_per_symbol;
+    uint64_t universe;
+    // Bitmap slice streaming through the library
+    match_symbols_t chunk;
+
+    arena memory;
+    z_stream deflate_stream;
+    z_stream inflate_stream;
+};
+// ============================================================================
@@ -29,9 +29,15 @@
 #include <fastac/adaptive_bit_model.hpp>
 
 #include <fastac/constants.hpp>
+#include <fastac/error.hpp>
+#include <fastac/model_snapshot.hpp>
 
 #include <iostream>
 // ============================================================================
+// "ABM1"
+static const uint32_t SNAPSHOT_TAG = 0x314D4241U;
+static const size_t SNAPSHOT_WORDS = 6;
+// ============================================================================
 adaptive_bit_model::adaptive_bit_model()
 {
     reset();
@@ -80,4 +86,34 @@ size_t adaptive_bit_model::memory_usage() const
 {
     return sizeof(*this);
 }
+// ----------------------------------------------------------------------------
+size_t adaptive_bit_model::snapshot_size() const
+{
+    return SNAPSHOT_WORDS * sizeof(uint32_t);
+}
+// ----------------------------------------------------------------------------
+void adaptive_bit_model::snapshot(uint8_t* buffer) const
+{
+    uint32_t const words[SNAPSHOT_WORDS] = {
+        SNAPSHOT_TAG, update_cycle, bits_until_update, bit_0_prob, bit_0_count, bit_count
+    };
+    snapshot_put(buffer, words, SNAPSHOT_WORDS);
+}
+// ----------------------------------------------------------------------------
+size_t adaptive_bit_model::restore(uint8_t const* buffer, size_t size)
+{
+    uint32_t words[SNAPSHOT_WORDS];
+    snapshot_get(buffer, buffer + size, words, SNAPSHOT_WORDS);
+    if ((words[0] != SNAPSHOT_TAG) || (words[1] == 0) || (words[3] >= (1U << BM__LengthShift))
+        || (words[5] == 0) || (words[4] > words[5])) {
+        AC_Error("invalid model snapshot");
+    }
+
+    update_cycle = words[1];
+    bits_until_update = words[2];
+    bit_0_prob = words[3];
+    bit_0_count = words[4];
+    bit_count = words[5];
+    return SNAPSHOT_WORDS * sizeof(uint32_t);
+}
 // ============================================================================
@@ -28,6 +28,7 @@
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 #pragma once
 // ============================================================================
+#include <cstddef>
 #include <cstdint>
 // ============================================================================
 // Adaptive model for binary data
@@ -42,6 +43,14 @@ public:
 
     size_t memory_usage() const;
 
+    // the model has no pointers, copies are plain assignments
+
+    // binary image of the model state, see model_snapshot.hpp
+    size_t snapshot_size() const;
+    void snapshot(uint8_t* buffer) const;
+    // returns the number of bytes read
+    size_t restore(uint8_t const* buffer, size_t size);
+
 private:
     void update();
 
@@ -30,9 +30,15 @@
 
 #include <fastac/constants.hpp>
 #include <fastac/error.hpp>
+#include <fastac/model_snapshot.hpp>
 
+#include <cstring>
 #include <iostream>
 // ============================================================================
+// "ADM1"
+static const uint32_t SNAPSHOT_TAG = 0x314D4441U;
+static const size_t SNAPSHOT_HEADER = 5;
+// ============================================================================
 adaptive_data_model::adaptive_data_model()
     : distribution(nullptr)
     , symbol_count(nullptr)
@@ -51,11 +57,27 @@ adaptive_data_model::adaptive_data_model(uint32_t number_of_symbols)
     set_alphabet(number_of_symbols);
 }
 // ----------------------------------------------------------------------------
+adaptive_data_model::adaptive_data_model(adaptive_data_model const& other)
+    : distribution(nullptr)
+    , symbol_count(nullptr)
+    , decoder_table(nullptr)
+    , data_memory_size(0)
+    , data_symbols(0)
+{
+    restore(other);
+}
+// ----------------------------------------------------------------------------
 adaptive_data_model::~adaptive_data_model()
 {
     delete[] distribution;
 }
 // ----------------------------------------------------------------------------
+adaptive_data_model& adaptive_data_model::operator=(adaptive_data_model const& other)
+{
+    restore(other);
+    return *this;
+}
+// ----------------------------------------------------------------------------
 void adaptive_data_model::set_alphabet(uint32_t number_of_symbols)
 {
     if ((number_of_symbols < 2) || (number_of_symbols > (1 << 11))) {
@@ -94,8 +116,10 @@ void adaptive_data_model::set_alphabet(uint32_t number_of_symbols)
     // initialize model
     reset();
 
+#ifdef _DEBUG
     std::cout << "$ adaptive_data_model : initialized (symbols="
         << data_symbols << ", memory=" << memory_usage() << ")\n";
+#endif
 }
 // ----------------------------------------------------------------------------
 void adaptive_data_model::update(bool from_encoder)
@@ -163,3 +187,75 @@ size_t adaptive_data_model::memory_usage() const
     return ((data_memory_size * sizeof(uint32_t)) + sizeof(*this));
 }
 // ============================================================================
+void adaptive_data_model::restore(adaptive_data_model const& other)
+{
+    if (this == &other) {
+        return;
+    }
+    if (other.data_symbols == 0) {
+        // copy of an empty model
+        delete[] distribution;
+        distribution = nullptr;
+        symbol_count = decoder_table = nullptr;
+        data_memory_size = 0;
+        data_symbols = 0;
+        return;
+    }
+    if (data_symbols != other.data_symbols) {
+        set_alphabet(other.data_symbols);
+    }
+
+    // distribution and counts are adjacent
+    std::memcpy(distribution, other.distribution, 2 * data_symbols * sizeof(uint32_t));
+    total_count = other.total_count;
+    update_cycle = other.update_cycle;
+    symbols_until_update = other.symbols_until_update;
+
+    // an encoder's table is stale, rebuild it
+    if (table_size != 0) {
+        snapshot_decoder_table(distribution, data_symbols, decoder_table, table_size, table_shift);
+    }
+}
+// ----------------------------------------------------------------------------
+size_t adaptive_data_model::snapshot_size() const
+{
+    return (SNAPSHOT_HEADER + 2 * size_t(data_symbols)) * sizeof(uint32_t);
+}
+// ----------------------------------------------------------------------------
+void adaptive_data_model::snapshot(uint8_t* buffer) const
+{
+    if (data_symbols == 0) {
+        AC_Error("no model to snapshot");
+    }
+
+    uint32_t const header[SNAPSHOT_HEADER] = {
+        SNAPSHOT_TAG, data_symbols, total_count, update_cycle, symbols_until_update
+    };
+    buffer = snapshot_put(buffer, header, SNAPSHOT_HEADER);
+    snapshot_put(buffer, distribution, 2 * data_symbols);
+}
+// ----------------------------------------------------------------------------
+size_t adaptive_data_model::restore(uint8_t const* buffer, size_t size)
+{
+    uint8_t const* const end(buffer + size);
+    uint32_t header[SNAPSHOT_HEADER];
+    uint8_t const* p(snapshot_get(buffer, end, header, SNAPSHOT_HEADER));
+    if ((header[0] != SNAPSHOT_TAG) || (header[3] == 0)) {
+        AC_Error("invalid model snapshot");
+    }
+    if (data_symbols != header[1]) {
+        set_alphabet(header[1]);
+    }
+
+    p = snapshot_get(p, end, distribution, 2 * data_symbols);
+    snapshot_check_distribution(distribution, data_symbols);
+    total_count = header[2];
+    update_cycle = header[3];
+    symbols_until_update = header[4];
+
+    if (table_size != 0) {
+        snapshot_decoder_table(distribution, data_symbols, decoder_table, table_size, table_shift);
+    }
+    return static_cast<size_t>(p - buffer);
+}
+// ============================================================================
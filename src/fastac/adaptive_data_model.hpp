@@ -28,6 +28,7 @@
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 #pragma once
 // ============================================================================
+#include <cstddef>
 #include <cstdint>
 // ============================================================================
 // adaptive model for general data
@@ -36,9 +37,12 @@ class adaptive_data_model
 public:
     adaptive_data_model();
     explicit adaptive_data_model(uint32_t number_of_symbols);
+    adaptive_data_model(adaptive_data_model const& other);
 
     ~adaptive_data_model();
 
+    adaptive_data_model& operator=(adaptive_data_model const& other);
+
     uint32_t model_symbols() const;
 
     // reset to equiprobable model
@@ -48,6 +52,16 @@ public:
 
     size_t memory_usage() const;
 
+    // copy of the state of `other` (e.g. a warmed-up template) in O(model
+    // size), no allocation when the alphabets match
+    void restore(adaptive_data_model const& other);
+
+    // binary image of the model state, see model_snapshot.hpp
+    size_t snapshot_size() const;
+    void snapshot(uint8_t* buffer) const;
+    // returns the number of bytes read
+    size_t restore(uint8_t const* buffer, size_t size);
+
 private:
     void update(bool from_encoder);
 
@@ -30,14 +30,21 @@
 
 #include <fastac/constants.hpp>
 #include <fastac/error.hpp>
+#include <fastac/model_snapshot.hpp>
 
+#include <cstring>
 #include <iostream>
 // ============================================================================
+// "AEM1"
+static const uint32_t SNAPSHOT_TAG = 0x314D4541U;
+static const size_t SNAPSHOT_HEADER = 5;
+// ============================================================================
 adaptive_esc_data_model::adaptive_esc_data_model()
     : distribution(nullptr)
     , symbol_count(nullptr)
     , decoder_table(nullptr)
     , data_memory_size(0)
+    , own_memory(false)
     , data_symbols(0)
 {
 }
@@ -46,17 +53,38 @@ adaptive_esc_data_model::adaptive_esc_data_model(uint32_t number_of_symbols)
     : distribution(nullptr)
     , symbol_count(nullptr)
     , decoder_table(nullptr)
+    , own_memory(false)
     , data_symbols(0)
 {
     set_alphabet(number_of_symbols);
 }
 // ----------------------------------------------------------------------------
+adaptive_esc_data_model::adaptive_esc_data_model(adaptive_esc_data_model const& other)
+    : distribution(nullptr)
+    , symbol_count(nullptr)
+    , decoder_table(nullptr)
+    , data_memory_size(0)
+    , own_memory(false)
+    , data_symbols(0)
+{
+    restore(other);
+}
+// ----------------------------------------------------------------------------
 adaptive_esc_data_model::~adaptive_esc_data_model()
 {
-    delete[] distribution;
+    if (own_memory) {
+        delete[] distribution;
+    }
+}
+// ----------------------------------------------------------------------------
+adaptive_esc_data_model& adaptive_esc_data_model::operator=(adaptive_esc_data_model const& other)
+{
+    restore(other);
+    return *this;
 }
 // ----------------------------------------------------------------------------
-void adaptive_esc_data_model::set_alphabet(uint32_t number_of_symbols)
+void adaptive_esc_data_model::set_alphabet(uint32_t number_of_symbols
+    , uint32_t* user_memory)
 {
     if ((number_of_symbols < 2) || (number_of_symbols > (1 << 11))) {
         AC_Error("invalid number of data symbols");
@@ -64,12 +92,15 @@ void adaptive_esc_data_model::set_alphabet(uint32_t number_of_symbols)
 
     uint32_t real_number_of_symbols = number_of_symbols + 1;
 
-    if (data_symbols != real_number_of_symbols) {
+    if ((data_symbols != real_number_of_symbols) || user_memory || !own_memory) {
         // assign memory for data model
         data_symbols = real_number_of_symbols;
         last_symbol = data_symbols - 1;
-        delete[] distribution;
-        
+        if (own_memory) {
+            delete[] distribution;
+        }
+
+        data_memory_size = memory_words(number_of_symbols);
         if (data_symbols > 16) {
             // define size of table for fast decoding
             uint32_t table_bits = 3;
@@ -78,16 +109,14 @@ void adaptive_esc_data_model::set_alphabet(uint32_t number_of_symbols)
             }
             table_size = (1 << table_bits) + 4;
             table_shift = DM__LengthShift - table_bits;
-            data_memory_size = 2 * data_symbols + table_size + 6;
-            distribution = new uint32_t[data_memory_size];
-            decoder_table = distribution + 2 * data_symbols;
         } else {
             // small alphabet: no table needed
-            decoder_table = nullptr;
             table_size = table_shift = 0;
-            data_memory_size = 2 * data_symbols;
-            distribution = new uint32_t[data_memory_size];
         }
+
+        own_memory = (user_memory == nullptr);
+        distribution = own_memory ? new uint32_t[data_memory_size] : user_memory;
+        decoder_table = (table_size != 0) ? distribution + 2 * data_symbols : nullptr;
         symbol_count = distribution + data_symbols;
         if (distribution == 0) {
             AC_Error("cannot assign model memory");
@@ -97,8 +126,10 @@ void adaptive_esc_data_model::set_alphabet(uint32_t number_of_symbols)
     // initialize model
     reset();
 
+#ifdef _DEBUG
     std::cout << "$ adaptive_esc_data_model : initialized (symbols="
         << data_symbols << ", memory=" << memory_usage() << ")\n";
+#endif
 }
 // ----------------------------------------------------------------------------
 void adaptive_esc_data_model::update(bool from_encoder)
@@ -203,4 +234,93 @@ size_t adaptive_esc_data_model::memory_usage() const
 {
     return ((data_memory_size * sizeof(uint32_t)) + sizeof(*this));
 }
+// ----------------------------------------------------------------------------
+size_t adaptive_esc_data_model::memory_words(uint32_t number_of_symbols)
+{
+    // regular symbols + escape: distribution and counts, then the table
+    uint32_t const symbols = number_of_symbols + 1;
+    if (symbols <= 16) {
+        return 2 * symbols;
+    }
+    uint32_t table_bits = 3;
+    while (symbols > (1U << (table_bits + 2))) {
+        ++table_bits;
+    }
+    return 2 * symbols + (1 << table_bits) + 4 + 6;
+}
+// ============================================================================
+void adaptive_esc_data_model::restore(adaptive_esc_data_model const& other)
+{
+    if (this == &other) {
+        return;
+    }
+    if (other.data_symbols == 0) {
+        // copy of an empty model
+        if (own_memory) {
+            delete[] distribution;
+        }
+        own_memory = false;
+        distribution = nullptr;
+        symbol_count = decoder_table = nullptr;
+        data_memory_size = 0;
+        data_symbols = 0;
+        return;
+    }
+    if (data_symbols != other.data_symbols) {
+        set_alphabet(other.data_symbols - 1);
+    }
+
+    // distribution and counts are adjacent
+    std::memcpy(distribution, other.distribution, 2 * data_symbols * sizeof(uint32_t));
+    total_count = other.total_count;
+    update_cycle = other.update_cycle;
+    symbols_until_update = other.symbols_until_update;
+
+    // an encoder's table is stale, rebuild it
+    if (table_size != 0) {
+        snapshot_decoder_table(distribution, data_symbols, decoder_table, table_size, table_shift);
+    }
+}
+// ----------------------------------------------------------------------------
+size_t adaptive_esc_data_model::snapshot_size() const
+{
+    return (SNAPSHOT_HEADER + 2 * size_t(data_symbols)) * sizeof(uint32_t);
+}
+// ----------------------------------------------------------------------------
+void adaptive_esc_data_model::snapshot(uint8_t* buffer) const
+{
+    if (data_symbols == 0) {
+        AC_Error("no model to snapshot");
+    }
+
+    uint32_t const header[SNAPSHOT_HEADER] = {
+        SNAPSHOT_TAG, data_symbols, total_count, update_cycle, symbols_until_update
+    };
+    buffer = snapshot_put(buffer, header, SNAPSHOT_HEADER);
+    snapshot_put(buffer, distribution, 2 * data_symbols);
+}
+// ----------------------------------------------------------------------------
+size_t adaptive_esc_data_model::restore(uint8_t const* buffer, size_t size)
+{
+    uint8_t const* const end(buffer + size);
+    uint32_t header[SNAPSHOT_HEADER];
+    uint8_t const* p(snapshot_get(buffer, end, header, SNAPSHOT_HEADER));
+    if ((header[0] != SNAPSHOT_TAG) || (header[1] == 0) || (header[3] == 0)) {
+        AC_Error("invalid model snapshot");
+    }
+    if (data_symbols != header[1]) {
+        set_alphabet(header[1] - 1);
+    }
+
+    p = snapshot_get(p, end, distribution, 2 * data_symbols);
+    snapshot_check_distribution(distribution, data_symbols);
+    total_count = header[2];
+    update_cycle = header[3];
+    symbols_until_update = header[4];
+
+    if (table_size != 0) {
+        snapshot_decoder_table(distribution, data_symbols, decoder_table, table_size, table_shift);
+    }
+    return static_cast<size_t>(p - buffer);
+}
 // ============================================================================
@@ -28,6 +28,7 @@
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 #pragma once
 // ============================================================================
+#include <cstddef>
 #include <cstdint>
 // ============================================================================
 // adaptive model for general data with escapes
@@ -36,9 +37,12 @@ class adaptive_esc_data_model
 public:
     adaptive_esc_data_model();
     explicit adaptive_esc_data_model(uint32_t number_of_symbols);
+    adaptive_esc_data_model(adaptive_esc_data_model const& other);
 
     ~adaptive_esc_data_model();
 
+    adaptive_esc_data_model& operator=(adaptive_esc_data_model const& other);
+
     uint32_t model_symbols() const;
 
     // reset to base (p_esc = 1.0)
@@ -49,10 +53,26 @@ public:
     uint32_t get_escape() const;
     void add_symbol(uint32_t symbol);
 
-    void set_alphabet(uint32_t number_of_symbols);
+    // `user_memory`, when given, holds memory_words(number_of_symbols) words
+    // and outlives the model (e.g. an arena); the model doesn't free it
+    void set_alphabet(uint32_t number_of_symbols, uint32_t* user_memory = nullptr);
 
     size_t memory_usage() const;
 
+    // copy of the state of `other` (e.g. a warmed-up template) in O(model
+    // size), no allocation when the alphabets match;
+    // user memory is kept then
+    void restore(adaptive_esc_data_model const& other);
+
+    // binary image of the model state, see model_snapshot.hpp
+    size_t snapshot_size() const;
+    void snapshot(uint8_t* buffer) const;
+    // returns the number of bytes read
+    size_t restore(uint8_t const* buffer, size_t size);
+
+    // Words of model memory set_alphabet needs
+    static size_t memory_words(uint32_t number_of_symbols);
+
 private:
     void update(bool);
 
@@ -61,6 +81,7 @@ private:
     uint32_t* symbol_count;
     uint32_t* decoder_table;
     size_t data_memory_size;
+    bool own_memory;
 
     uint32_t total_count;
     uint32_t update_cycle;
@@ -79,7 +79,8 @@ void arithmetic_codec::set_buffer(uint32_t max_code_bytes, uint8_t* user_buffer)
         return;
     }
 
-    if (max_code_bytes <= buffer_size) {
+    // a previous user buffer is never reused as our own
+    if ((new_buffer != nullptr) && (max_code_bytes <= buffer_size)) {
         return; // enough available
     }
 
@@ -106,6 +107,10 @@ inline void arithmetic_codec::propagate_carry()
 inline void arithmetic_codec::renorm_enc_interval()
 {
     do {                                          
+        if (ac_pointer >= code_end) {
+            mode = 0; // encoder can be restarted
+            AC_Error("code buffer overflow");
+        }
         // output and discard top byte
         *ac_pointer++ = static_cast<uint8_t>(base >> 24);
         base <<= 8;
@@ -115,8 +120,10 @@ inline void arithmetic_codec::renorm_enc_interval()
 inline void arithmetic_codec::renorm_dec_interval()
 {
     do {
-        // read least-significant byte
-        value = (value << 8) | static_cast<uint32_t>(*++ac_pointer);
+        // read least-significant byte (zeros past the end of the code)
+        ++ac_pointer;
+        uint32_t byte = (ac_pointer < code_end) ? static_cast<uint32_t>(*ac_pointer) : 0;
+        value = (value << 8) | byte;
     } while ((length <<= 8) < AC__MinLength); // length multiplied by 256
 }
 // ============================================================================
@@ -178,6 +185,23 @@ void arithmetic_codec::put_bits(uint32_t data, uint32_t bits)
     }
 }
 // ----------------------------------------------------------------------------
+void arithmetic_codec::put_wide_bits(uint64_t data, uint32_t bits)
+{
+#ifdef _DEBUG
+    if (bits > 64) AC_Error("invalid number of bits");
+    if ((bits < 64) && (data >> bits)) AC_Error("invalid data");
+#endif
+
+    // put_bits takes at most 20 bits, low chunks first
+    for (; bits > 16; bits -= 16) {
+        put_bits(static_cast<uint32_t>(data & 0xFFFFU), 16);
+        data >>= 16;
+    }
+    if (bits > 0) {
+        put_bits(static_cast<uint32_t>(data), bits);
+    }
+}
+// ----------------------------------------------------------------------------
 uint32_t arithmetic_codec::get_bits(uint32_t bits)
 {
 #ifdef _DEBUG
@@ -194,6 +218,24 @@ uint32_t arithmetic_codec::get_bits(uint32_t bits)
 
     return s;
 }
+// ----------------------------------------------------------------------------
+uint64_t arithmetic_codec::get_wide_bits(uint32_t bits)
+{
+#ifdef _DEBUG
+    if (bits > 64) AC_Error("invalid number of bits");
+#endif
+
+    uint64_t data(0);
+    uint32_t shift(0);
+    for (; bits > 16; bits -= 16) {
+        data |= static_cast<uint64_t>(get_bits(16)) << shift;
+        shift += 16;
+    }
+    if (bits > 0) {
+        data |= static_cast<uint64_t>(get_bits(bits)) << shift;
+    }
+    return data;
+}
 // ============================================================================
 void arithmetic_codec::encode(uint32_t bit, static_bit_model& M)
 {
@@ -244,6 +286,55 @@ uint32_t arithmetic_codec::decode(static_bit_model& M)
     return bit; // return data bit value
 }
 // ============================================================================
+void arithmetic_codec::encode_bit(uint32_t bit, uint32_t probability_0)
+{
+#ifdef _DEBUG
+    if (mode != 1) AC_Error("encoder not initialized");
+#endif
+
+    uint32_t x = probability_0 * (length >> PM__LengthShift); // product l x p0
+
+    // update interval
+    if (bit == 0) {
+        length = x;
+    } else {
+        uint32_t init_base = base;
+        base += x;
+        length -= x;
+        if (init_base > base) {
+            propagate_carry(); // overflow = carry
+        }
+    }
+
+    if (length < AC__MinLength) {
+        renorm_enc_interval(); // renormalization
+    }
+}
+// ----------------------------------------------------------------------------
+uint32_t arithmetic_codec::decode_bit(uint32_t probability_0)
+{
+#ifdef _DEBUG
+    if (mode != 2) AC_Error("decoder not initialized");
+#endif
+
+    uint32_t x = probability_0 * (length >> PM__LengthShift); // product l x p0
+    uint32_t bit = (value >= x); // decision
+
+    // update & shift interval
+    if (bit == 0) {
+        length = x;
+    } else {
+        value -= x; // shifted interval base = 0
+        length -= x;
+    }
+
+    if (length < AC__MinLength) {
+        renorm_dec_interval(); // renormalization
+    }
+
+    return bit; // return data bit value
+}
+// ============================================================================
 void arithmetic_codec::encode(uint32_t bit, adaptive_bit_model& M)
 {
 #ifdef _DEBUG
@@ -597,6 +688,7 @@ void arithmetic_codec::start_encoder()
     base = 0;  // initialize encoder variables: interval and pointer
     length = AC__MaxLength;
     ac_pointer = code_buffer; // pointer to next data byte
+    code_end = code_buffer + buffer_size;
 }
 // ----------------------------------------------------------------------------
 void arithmetic_codec::start_decoder()
@@ -611,11 +703,14 @@ void arithmetic_codec::start_decoder()
     // initialize decoder: interval, pointer, initial code value
     mode = 2;
     length = AC__MaxLength;
+    code_end = code_buffer + buffer_size;
     ac_pointer = code_buffer + 3;
-    value = (static_cast<uint32_t>(code_buffer[0]) << 24)
-        | (static_cast<uint32_t>(code_buffer[1]) << 16)
-        | (static_cast<uint32_t>(code_buffer[2]) << 8)
-        | static_cast<uint32_t>(code_buffer[3]);
+    value = 0;
+    for (uint32_t i(0); i < 4; ++i) {
+        // decoder reads ahead, code bytes past the buffer are zeros
+        uint32_t byte = (i < buffer_size) ? static_cast<uint32_t>(code_buffer[i]) : 0;
+        value = (value << 8) | byte;
+    }
 }
 // ----------------------------------------------------------------------------
 uint32_t arithmetic_codec::stop_encoder()
@@ -651,6 +746,47 @@ uint32_t arithmetic_codec::stop_encoder()
     return code_bytes; // number of bytes used
 }
 // ----------------------------------------------------------------------------
+uint32_t arithmetic_codec::stop_encoder_trimmed()
+{
+    if (mode != 1) {
+        AC_Error("invalid to stop encoder");
+    }
+
+    mode = 0;
+
+    // any value of [base, base + length) decodes the same: take the one with
+    // all 4 bytes zero if the interval holds it, else one with the low 3
+    // zero, which it always holds as length >= 2^24
+    uint64_t const end = uint64_t(base) + length;
+    uint32_t bytes = 0;
+    uint64_t final_value = (uint64_t(base) + 0xFFFFFFFFU) & ~uint64_t(0xFFFFFFFFU);
+    if (final_value >= end) {
+        bytes = 1;
+        final_value = (uint64_t(base) + 0xFFFFFFU) & ~uint64_t(0xFFFFFFU);
+    }
+
+    // overflow = carry, there is always a byte to carry into then
+    if (final_value >> 32) {
+        propagate_carry();
+    }
+
+    base = static_cast<uint32_t>(final_value);
+    for (uint32_t i = 0; i < bytes; ++i) {
+        if (ac_pointer >= code_end) {
+            AC_Error("code buffer overflow");
+        }
+        *ac_pointer++ = static_cast<uint8_t>(base >> 24);
+        base <<= 8;
+    }
+
+    // decoder reads zeros past the end of the code
+    while ((ac_pointer > code_buffer) && (ac_pointer[-1] == 0)) {
+        --ac_pointer;
+    }
+
+    return static_cast<uint32_t>(ac_pointer - code_buffer); // number of bytes used
+}
+// ----------------------------------------------------------------------------
 void arithmetic_codec::stop_decoder()
 {
     if (mode != 2) {
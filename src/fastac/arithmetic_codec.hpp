@@ -58,6 +58,10 @@ public:
     void read_from_file(FILE * code_file); // read code data, start decoder
 
     uint32_t stop_encoder(); // returns number of bytes used
+    // As stop_encoder, but ends on the fewest bytes (often none) and drops
+    // trailing zeros: the code must be decoded from a buffer that ends with
+    // it, the decoder reading zeros past the end
+    uint32_t stop_encoder_trimmed();
     uint32_t write_to_file(FILE * code_file); // stop encoder, write code data
     void stop_decoder();
 
@@ -67,6 +71,15 @@ public:
     void put_bits(uint32_t data, uint32_t number_of_bits);
     uint32_t get_bits(uint32_t number_of_bits);
 
+    // up to 64 bits, coded as several put_bits fields
+    void put_wide_bits(uint64_t data, uint32_t number_of_bits);
+    uint64_t get_wide_bits(uint32_t number_of_bits);
+
+    // probability_0 scaled to PM__LengthShift (16) bits, 1 .. 65535; for
+    // models that compute their own probability for every bit
+    void encode_bit(uint32_t bit, uint32_t probability_0);
+    uint32_t decode_bit(uint32_t probability_0);
+
     void encode(uint32_t bit,static_bit_model &);
     uint32_t decode(static_bit_model &);
 
@@ -91,6 +104,7 @@ private:
     uint8_t* code_buffer;
     uint8_t* new_buffer;
     uint8_t* ac_pointer;
+    uint8_t* code_end;
     uint32_t base, value, length; // arithmetic coding state
     uint32_t buffer_size, mode; // mode: 0 = undef, 1 = encoder, 2 = decoder
 };
@@ -42,6 +42,8 @@ const uint32_t AC__MaxLength = 0xFFFFFFFFU;
 const uint32_t BM__LengthShift = 13;
 // for adaptive models
 const uint32_t BM__MaxCount = 1 << BM__LengthShift;
+// for probabilities given per bit (encode_bit / decode_bit)
+const uint32_t PM__LengthShift = 16;
 
 // Maximum values for general models
 
@@ -41,6 +41,8 @@ extern const uint32_t AC__MaxLength;
 extern const uint32_t BM__LengthShift;
 // for adaptive models
 extern const uint32_t BM__MaxCount;
+// for probabilities given per bit (encode_bit / decode_bit)
+extern const uint32_t PM__LengthShift;
 
 // Maximum values for general models
 
@@ -0,0 +1,67 @@
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Model snapshots: a tag word naming the model class, then the model state
+// as 32-bit words in host byte order. Decoder tables are not stored, they
+// are rebuilt from the cumulative distribution on restore.
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+#pragma once
+// ============================================================================
+#include <fastac/constants.hpp>
+#include <fastac/error.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+// ============================================================================
+inline uint8_t* snapshot_put(uint8_t* buffer, uint32_t const* words, size_t count)
+{
+    std::memcpy(buffer, words, count * sizeof(uint32_t));
+    return buffer + count * sizeof(uint32_t);
+}
+// ----------------------------------------------------------------------------
+inline uint8_t const* snapshot_get(uint8_t const* buffer
+    , uint8_t const* end
+    , uint32_t* words
+    , size_t count)
+{
+    if (size_t(end - buffer) < count * sizeof(uint32_t)) {
+        AC_Error("truncated model snapshot");
+    }
+    std::memcpy(words, buffer, count * sizeof(uint32_t));
+    return buffer + count * sizeof(uint32_t);
+}
+// ----------------------------------------------------------------------------
+// Cumulative distributions start at 0, never decrease and stay below
+// 2^DM__LengthShift; anything else would send the decoder out of bounds
+inline void snapshot_check_distribution(uint32_t const* distribution, uint32_t data_symbols)
+{
+    if (distribution[0] != 0) {
+        AC_Error("invalid model snapshot");
+    }
+    for (uint32_t k(1); k < data_symbols; ++k) {
+        if ((distribution[k] < distribution[k - 1])
+            || (distribution[k] >= (1U << DM__LengthShift))) {
+            AC_Error("invalid model snapshot");
+        }
+    }
+}
+// ----------------------------------------------------------------------------
+// Decoder table of a cumulative distribution, as the models build it
+inline void snapshot_decoder_table(uint32_t const* distribution
+    , uint32_t data_symbols
+    , uint32_t* decoder_table
+    , uint32_t table_size
+    , uint32_t table_shift)
+{
+    uint32_t s(0);
+    for (uint32_t k(0); k < data_symbols; ++k) {
+        uint32_t w = distribution[k] >> table_shift;
+        while (s < w) {
+            decoder_table[++s] = k - 1;
+        }
+    }
+    decoder_table[0] = 0;
+    while (s <= table_size) {
+        decoder_table[++s] = data_symbols - 1;
+    }
+}
+// ============================================================================
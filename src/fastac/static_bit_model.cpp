@@ -50,6 +50,10 @@ void static_bit_model::set_probability_0(double p0)
     }
 
     bit_0_prob = static_cast<uint32_t>(p0 * (1 << BM__LengthShift));
+    // p0 = 0.0001 truncates to 0, which would collapse the interval
+    if (bit_0_prob == 0) {
+        bit_0_prob = 1;
+    }
 }
 // ----------------------------------------------------------------------------
 size_t static_bit_model::memory_usage() const
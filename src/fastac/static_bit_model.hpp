@@ -39,6 +39,8 @@ public:
 
     // set probability of symbol '0'
     void set_probability_0(double p0);
+    // probability of symbol '0' scaled to BM__LengthShift bits
+    uint32_t scaled_probability_0() const;
 
     size_t memory_usage() const;
 
@@ -49,3 +51,8 @@ private:
     friend class arithmetic_codec;
 };
 // ============================================================================
+inline uint32_t static_bit_model::scaled_probability_0() const
+{
+    return bit_0_prob;
+}
+// ============================================================================
@@ -30,9 +30,15 @@
 
 #include <fastac/constants.hpp>
 #include <fastac/error.hpp>
+#include <fastac/model_snapshot.hpp>
 
+#include <cstring>
 #include <iostream>
 // ============================================================================
+// "SDM1"
+static const uint32_t SNAPSHOT_TAG = 0x314D4453U;
+static const size_t SNAPSHOT_HEADER = 2;
+// ============================================================================
 static_data_model::static_data_model()
     : distribution(nullptr)
     , decoder_table(nullptr)
@@ -52,12 +58,27 @@ static_data_model::static_data_model(uint32_t number_of_symbols
     set_distribution(number_of_symbols, probability);
 }
 // ----------------------------------------------------------------------------
+static_data_model::static_data_model(static_data_model const& other)
+    : distribution(nullptr)
+    , decoder_table(nullptr)
+    , data_memory_size(0)
+    , data_symbols(0)
+{
+    restore(other);
+}
+// ----------------------------------------------------------------------------
 static_data_model::~static_data_model()
 {
     delete[] distribution;
     // std::cout << "$ static_data_model : destroyed\n";
 }
 // ----------------------------------------------------------------------------
+static_data_model& static_data_model::operator=(static_data_model const& other)
+{
+    restore(other);
+    return *this;
+}
+// ----------------------------------------------------------------------------
 void static_data_model::set_distribution(uint32_t number_of_symbols
     , const double probability[])
 {
@@ -129,8 +150,10 @@ void static_data_model::set_distribution(uint32_t number_of_symbols
         AC_Error("Invalid probabilities");
     }
 
+#ifdef _DEBUG
     std::cout << "$ static_data_model : initialized (symbols="
         << data_symbols << ", memory=" << memory_usage() << ")\n";
+#endif
 }
 // ----------------------------------------------------------------------------
 size_t static_data_model::memory_usage() const
@@ -138,3 +161,62 @@ size_t static_data_model::memory_usage() const
     return ((data_memory_size * sizeof(uint32_t)) + sizeof(*this));
 }
 // ============================================================================
+void static_data_model::restore(static_data_model const& other)
+{
+    if (this == &other) {
+        return;
+    }
+    if (other.data_symbols == 0) {
+        // copy of an empty model
+        delete[] distribution;
+        distribution = nullptr;
+        decoder_table = nullptr;
+        data_memory_size = 0;
+        data_symbols = 0;
+        return;
+    }
+    if (data_symbols != other.data_symbols) {
+        set_distribution(other.data_symbols);
+    }
+
+    // same alphabet, same layout: distribution and table in one piece
+    std::memcpy(distribution, other.distribution, data_memory_size * sizeof(uint32_t));
+}
+// ----------------------------------------------------------------------------
+size_t static_data_model::snapshot_size() const
+{
+    return (SNAPSHOT_HEADER + size_t(data_symbols)) * sizeof(uint32_t);
+}
+// ----------------------------------------------------------------------------
+void static_data_model::snapshot(uint8_t* buffer) const
+{
+    if (data_symbols == 0) {
+        AC_Error("no model to snapshot");
+    }
+
+    uint32_t const header[SNAPSHOT_HEADER] = { SNAPSHOT_TAG, data_symbols };
+    buffer = snapshot_put(buffer, header, SNAPSHOT_HEADER);
+    snapshot_put(buffer, distribution, data_symbols);
+}
+// ----------------------------------------------------------------------------
+size_t static_data_model::restore(uint8_t const* buffer, size_t size)
+{
+    uint8_t const* const end(buffer + size);
+    uint32_t header[SNAPSHOT_HEADER];
+    uint8_t const* p(snapshot_get(buffer, end, header, SNAPSHOT_HEADER));
+    if (header[0] != SNAPSHOT_TAG) {
+        AC_Error("invalid model snapshot");
+    }
+    if (data_symbols != header[1]) {
+        set_distribution(header[1]);
+    }
+
+    p = snapshot_get(p, end, distribution, data_symbols);
+    snapshot_check_distribution(distribution, data_symbols);
+
+    if (table_size != 0) {
+        snapshot_decoder_table(distribution, data_symbols, decoder_table, table_size, table_shift);
+    }
+    return static_cast<size_t>(p - buffer);
+}
+// ============================================================================
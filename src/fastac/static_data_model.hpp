@@ -28,6 +28,7 @@
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 #pragma once
 // ============================================================================
+#include <cstddef>
 #include <cstdint>
 // ============================================================================
 // static model for general data
@@ -37,9 +38,12 @@ public:
     static_data_model();
     explicit static_data_model(uint32_t number_of_symbols
         , const double probability[] = 0);
+    static_data_model(static_data_model const& other);
 
     ~static_data_model();
 
+    static_data_model& operator=(static_data_model const& other);
+
     uint32_t model_symbols() const;
 
     // 0 means uniform
@@ -48,6 +52,16 @@ public:
 
     size_t memory_usage() const;
 
+    // copy of the state of `other` (e.g. a warmed-up template) in O(model
+    // size), no allocation when the alphabets match
+    void restore(static_data_model const& other);
+
+    // binary image of the model state, see model_snapshot.hpp
+    size_t snapshot_size() const;
+    void snapshot(uint8_t* buffer) const;
+    // returns the number of bytes read
+    size_t restore(uint8_t const* buffer, size_t size);
+
 private:
     uint32_t* distribution;
     uint32_t* decoder_table;
@@ -1,459 +1,329 @@
 #include "utilities.hpp"
 
+#include <fastac/adaptive_bit_model.hpp>
+#include <fastac/adaptive_data_model.hpp>
+#include <fastac/adaptive_esc_data_model.hpp>
 #include <fastac/arithmetic_codec.hpp>
-#include <fastac/static_bit_model.hpp>
 #include <fastac/static_data_model.hpp>
 
+#include <bslc/arithmetic_codec_v1.hpp>
+#include <bslc/arithmetic_codec_v2.hpp>
+#include <bslc/batch_compressor.hpp>
+#include <bslc/bzip2_codec.hpp>
+#include <bslc/delta_codec.hpp>
+#include <bslc/estimators.hpp>
+#include <bslc/gap_codec.hpp>
+#include <bslc/interleaved_codec.hpp>
+#include <bslc/match_list.hpp>
+#include <bslc/multi_list_codec.hpp>
+#include <bslc/segmented_codec.hpp>
+#include <bslc/snappy_codec.hpp>
+#include <bslc/thread_pool.hpp>
+#include <bslc/workload.hpp>
+#include <bslc/zlib_codec.hpp>
+
 #include <algorithm>
-#include <cassert>
+#include <chrono>
 #include <cmath>
 #include <iostream>
 #include <numeric>
 #include <random>
 #include <set>
+#include <stdexcept>
 #include <vector>
-
-#include <bzlib.h>
-#undef max
-#undef min
-#include <zlib.h>
-#include <snappy-c.h>
-// ============================================================================
-typedef std::vector<uint8_t> match_symbols_t;
-typedef std::vector<uint32_t> match_list_t;
-typedef std::set<uint32_t> match_set_t;
-typedef std::vector<uint8_t> buffer_t;
-// ----------------------------------------------------------------------------
-static uint32_t const NUM_VALUES(1000000);
 // ============================================================================
 match_list_t make_random_matches(uint32_t n)
 {
-    static std::default_random_engine generator;
-    static std::uniform_int_distribution<uint32_t> distribution(0, NUM_VALUES - 1);
-
-    match_set_t result;
-    while (result.size() < n) {
-        result.insert(distribution(generator));
-    }
-
-    return match_list_t(result.begin(), result.end());
-}
-// ----------------------------------------------------------------------------
-size_t symbol_count(uint8_t bits)
-{
-    size_t count(NUM_VALUES / bits);
-    if (NUM_VALUES % bits > 0) {
-        return count + 1;
-    }
-    return count;
+    static workload_generator generator;
+    return generator.uniform(NUM_VALUES, n);
 }
 // ----------------------------------------------------------------------------
-void set_symbol(match_symbols_t& symbols, uint8_t bits, uint32_t match, bool state)
+// Next version of a list: each match removed with probability `changed` / 2
+// and about as many new ones added, as in successive snapshots of one list
+match_list_t make_next_version(match_list_t const& matches, double changed)
 {
-    size_t index(match / bits);
-    size_t offset(match % bits);
-    if (state) {
-        symbols[index] |= 1 << offset;
-    } else {
-        symbols[index] &= ~(1 << offset);
-    }
-}
-// ----------------------------------------------------------------------------
-bool get_symbol(match_symbols_t const& symbols, uint8_t bits, uint32_t match)
-{
-    size_t index(match / bits);
-    size_t offset(match % bits);
-    return (symbols[index] & (1 << offset)) != 0;
-}
-// ----------------------------------------------------------------------------
-match_symbols_t make_symbols(match_list_t const& matches, uint8_t bits)
-{
-    assert((bits > 0) && (bits <= 8));
-
-    match_symbols_t symbols(symbol_count(bits), 0);
-    for (auto match : matches) {
-        set_symbol(symbols, bits, match, true);
-    }
-
-    return symbols;
-}
-// ----------------------------------------------------------------------------
-match_list_t make_matches(match_symbols_t const& symbols, uint8_t bits)
-{
-    match_list_t result;
-    for (uint32_t i(0); i < 1000000; ++i) {
-        if (get_symbol(symbols, bits, i)) {
-            result.push_back(i);
+    static std::mt19937 generator(2);
+    std::bernoulli_distribution removed(changed / 2);
+    std::uniform_int_distribution<uint32_t> value(0, NUM_VALUES - 1);
+
+    std::set<uint32_t> version;
+    for (uint32_t match : matches) {
+        if (!removed(generator)) {
+            version.insert(match);
         }
     }
-    return result;
-}
-// ----------------------------------------------------------------------------
-std::vector<uint32_t> gen_test_sizes()
-{
-    std::vector<uint32_t> result;
-    for (uint32_t n(0); n < 100; n += 1) {
-        result.push_back(n);
-    }
-    for (uint32_t n(100); n < 500; n += 10) {
-        result.push_back(n);
-    }
-    for (uint32_t n(500); n < 3000; n += 100) {
-        result.push_back(n);
-    }
-    for (uint32_t n(3000); n < 15000; n += 1000) {
-        result.push_back(n);
-    }
-    for (uint32_t n(15000); n < 50000; n += 5000) {
-        result.push_back(n);
-    }
-    for (uint32_t n(50000); n <= 500000; n += 50000) {
-        result.push_back(n);
+    size_t const additions(std::min<size_t>(static_cast<size_t>(matches.size() * changed / 2 + 0.5)
+        , NUM_VALUES - version.size()));
+    for (size_t added(0); added < additions;) {
+        if (version.insert(value(generator)).second) {
+            ++added;
+        }
     }
-    return result;
+    return match_list_t(version.begin(), version.end());
 }
 // ----------------------------------------------------------------------------
 uint32_t estimate_size(match_list_t const& matches)
 {
-    match_symbols_t symbols = make_symbols(matches, 1);
-
-    std::map<uint8_t, uint32_t> alphabet;
-    double entropy = calculate_entropy(symbols, alphabet);
-    double best_size(entropy * NUM_VALUES);
+    // Order-0 entropy of the bitmap, straight from the matches
+    double best_size(bitmap_entropy_bits(matches, NUM_VALUES, 0));
 
     return static_cast<uint32_t>(std::ceil(best_size / 8.0));
 }
 // ============================================================================
-class arithmetic_codec_v1
+void run_estimate(uint32_t match_count)
 {
-public:
-    buffer_t compress(match_list_t const& matches)
-    {
-        uint32_t match_count(static_cast<uint32_t>(matches.size()));
-
-        arithmetic_codec codec(static_cast<uint32_t>(NUM_VALUES / 4));
-        codec.start_encoder();
-
-        // Store the number of matches (1000000 needs only 20 bits)
-        codec.put_bits(match_count, 20);
-
-        if (match_count > 0) {
-            // Initialize the model
-            static_bit_model model;
-            model.set_probability_0(get_probability_0(match_count));
-
-            // Create a bitmap and code all the bitmap entries
-            // NB: This is lazy and inefficient, but simple
-            match_symbols_t symbols = make_symbols(matches, 1);
-            for (auto entry : symbols) {
-                codec.encode(entry, model);
-            }
-        }
+    std::vector<uint32_t> est_size;
 
-        uint32_t compressed_size = codec.stop_encoder();
-        return buffer_t(codec.buffer(), codec.buffer() + compressed_size);
+    uint32_t const ITER_COUNT(16);
+    for (uint32_t i(0); i < ITER_COUNT; ++i) {
+        match_list_t matches = make_random_matches(match_count);
+
+        est_size.push_back(estimate_size(matches));
     }
 
-    match_list_t decompress(buffer_t& compressed)
-    {
-        arithmetic_codec codec(static_cast<uint32_t>(compressed.size()), &compressed[0]);
-        codec.start_decoder();
+    if (std::set<uint32_t>(est_size.begin(), est_size.end()).size() != 1) {
+        throw std::runtime_error("This shoudn't happen.");
+    }
 
-        // Read number of matches (20 bits)
-        uint32_t match_count(codec.get_bits(20));
+    std::cout << match_count << "," << est_size.front() << "\n";
+}
+// ============================================================================
+template<typename Codec>
+void run_test(Codec& codec, uint32_t match_count)
+{
+    std::vector<uint32_t> comp_size;
 
-        match_list_t result;
-        if (match_count > 0) {
-            static_bit_model model;
-            model.set_probability_0(get_probability_0(match_count));
+    uint32_t const ITER_COUNT(16);
+    for (uint32_t i(0); i < ITER_COUNT; ++i) {
+        match_list_t matches = make_random_matches(match_count);
 
-            result.reserve(match_count);
-            for (uint32_t i(0); i < NUM_VALUES; ++i) {
-                uint32_t entry = codec.decode(model);
-                if (entry == 1) {
-                    result.push_back(i);
-                }
-            }
-        }
+        buffer_t compressed = codec.compress(matches);
+        comp_size.push_back(static_cast<uint32_t>(compressed.size()));
 
-        codec.stop_decoder();
-        return result;
+        match_list_t decompressed = codec.decompress(compressed);
+        if (!(matches == decompressed)) {
+            throw std::runtime_error("Codec error.");
+        }
     }
 
-private:
-    double get_probability_0(uint32_t match_count, uint32_t num_values = NUM_VALUES)
-    {
-        double probability_0(double(num_values - match_count) / num_values);
-        // Limit probability to match FastAC limitations...
-        return std::max(0.0001, std::min(0.9999, probability_0));
-    }
-};
+    double sum = std::accumulate(comp_size.begin(), comp_size.end(), uint32_t(0));
+    std::cout << match_count << "," << (sum / ITER_COUNT) << "\n";
+}
 // ----------------------------------------------------------------------------
-class arithmetic_codec_v2
+// Delta of a list against its previous version, next to the list compressed
+// on its own
+void run_test_delta(delta_codec& codec, uint32_t match_count, double changed)
 {
-public:
-    buffer_t compress(match_list_t const& matches)
-    {
-        uint32_t match_count(static_cast<uint32_t>(matches.size()));
-        uint32_t total_count(NUM_VALUES);
-
-        arithmetic_codec codec(static_cast<uint32_t>(NUM_VALUES / 4));
-        codec.start_encoder();
-
-        // Store the number of matches (1000000 needs only 20 bits)
-        codec.put_bits(match_count, 20);
-
-        if (match_count > 0) {
-            static_bit_model model;
-
-            // Create a bitmap and code all the bitmap entries
-            // NB: This is lazy and inefficient, but simple
-            match_symbols_t symbols = make_symbols(matches, 1);
-            for (auto entry : symbols) {
-                model.set_probability_0(get_probability_0(match_count, total_count));
-                codec.encode(entry, model);
-                --total_count;
-                if (entry) {
-                    --match_count;
-                }
-                if (match_count == 0) {
-                    break;
-                }
-            }
-        }
+    gap_codec reference_codec;
+    std::vector<uint32_t> delta_size;
+    std::vector<uint32_t> gap_size;
 
-        uint32_t compressed_size = codec.stop_encoder();
-        return buffer_t(codec.buffer(), codec.buffer() + compressed_size);
-    }
-
-    match_list_t decompress(buffer_t& compressed)
-    {
-        arithmetic_codec codec(static_cast<uint32_t>(compressed.size()), &compressed[0]);
-        codec.start_decoder();
-
-        // Read number of matches (20 bits)
-        uint32_t match_count(codec.get_bits(20));
-        uint32_t total_count(NUM_VALUES);
-
-        match_list_t result;
-        if (match_count > 0) {
-            static_bit_model model;
-            result.reserve(match_count);
-            for (uint32_t i(0); i < NUM_VALUES; ++i) {
-                model.set_probability_0(get_probability_0(match_count, NUM_VALUES - i));
-                if (codec.decode(model) == 1) {
-                    result.push_back(i);
-                    --match_count;
-                }
-                if (match_count == 0) {
-                    break;
-                }
-            }
-        }
+    uint32_t const ITER_COUNT(16);
+    for (uint32_t i(0); i < ITER_COUNT; ++i) {
+        match_list_t reference = make_random_matches(match_count);
+        match_list_t matches = make_next_version(reference, changed);
 
-        codec.stop_decoder();
-        return result;
-    }
+        buffer_t delta = codec.delta(reference, matches);
+        delta_size.push_back(static_cast<uint32_t>(delta.size()));
+        gap_size.push_back(static_cast<uint32_t>(reference_codec.compress(matches).size()));
 
-private:
-    double get_probability_0(uint32_t match_count, uint32_t num_values = NUM_VALUES)
-    {
-        double probability_0(double(num_values - match_count) / num_values);
-        // Limit probability to match FastAC limitations...
-        return std::max(0.0001, std::min(0.9999, probability_0));
+        match_list_t applied = codec.apply(reference, delta);
+        if (!(matches == applied)) {
+            throw std::runtime_error("Codec error.");
+        }
     }
-};
+
+    double delta_sum = std::accumulate(delta_size.begin(), delta_size.end(), uint32_t(0));
+    double gap_sum = std::accumulate(gap_size.begin(), gap_size.end(), uint32_t(0));
+    std::cout << match_count << "," << (delta_sum / ITER_COUNT) << "," << (gap_sum / ITER_COUNT) << "\n";
+}
 // ----------------------------------------------------------------------------
-class zlib_codec
+double elapsed_ns(std::chrono::steady_clock::time_point start)
 {
-public:
-    zlib_codec(uint32_t bits_per_symbol) : bits_per_symbol(bits_per_symbol) {}
-
-    buffer_t compress(match_list_t const& matches)
-    {
-        match_symbols_t symbols(make_symbols(matches, bits_per_symbol));
-
-        z_stream defstream;
-        defstream.zalloc = nullptr;
-        defstream.zfree = nullptr;
-        defstream.opaque = nullptr;
-
-        deflateInit(&defstream, Z_BEST_COMPRESSION);
-        size_t max_compress_size = deflateBound(&defstream, static_cast<uLong>(symbols.size()));
-
-        buffer_t compressed(max_compress_size);
-
-        defstream.avail_in = static_cast<uInt>(symbols.size());
-        defstream.next_in = &symbols[0];
-        defstream.avail_out = static_cast<uInt>(max_compress_size);
-        defstream.next_out = &compressed[0];
-
-        deflate(&defstream, Z_FINISH);
-        deflateEnd(&defstream);
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+}
+// ----------------------------------------------------------------------------
+// Many lists in one multi_list_codec stream against each coded on its own
+// with gap_codec. Per list: bytes of both, compress and decompress ns of
+// both, then ns to decompress_list one list at random
+void run_test_multi_list(multi_list_codec& codec, uint32_t match_count)
+{
+    uint32_t const LIST_COUNT(10000);
+    uint32_t const ACCESS_COUNT(1000);
 
-        compressed.resize(defstream.total_out);
-        return compressed;
+    std::vector<match_list_t> lists;
+    for (uint32_t i(0); i < LIST_COUNT; ++i) {
+        lists.push_back(make_random_matches(match_count));
     }
 
-    match_list_t decompress(buffer_t& compressed)
-    {
-        z_stream infstream;
-        infstream.zalloc = nullptr;
-        infstream.zfree = nullptr;
-        infstream.opaque = nullptr;
-
-        inflateInit(&infstream);
-
-        match_symbols_t symbols(symbol_count(bits_per_symbol));
+    auto start = std::chrono::steady_clock::now();
+    buffer_t compressed = codec.compress(lists);
+    double const multi_compress_ns(elapsed_ns(start));
 
-        infstream.avail_in = static_cast<uInt>(compressed.size());
-        infstream.next_in = &compressed[0];
-        infstream.avail_out = static_cast<uInt>(symbols.size());
-        infstream.next_out = &symbols[0];
-
-        inflate(&infstream, Z_FINISH);
-        inflateEnd(&infstream);
+    std::vector<match_list_t> decompressed;
+    start = std::chrono::steady_clock::now();
+    codec.decompress(compressed, decompressed);
+    double const multi_decompress_ns(elapsed_ns(start));
+    if (!(lists == decompressed)) {
+        throw std::runtime_error("Codec error.");
+    }
 
-        return make_matches(symbols, bits_per_symbol);
+    gap_codec list_codec;
+    std::vector<buffer_t> gap_lists;
+    start = std::chrono::steady_clock::now();
+    for (match_list_t const& list : lists) {
+        gap_lists.push_back(list_codec.compress(list));
+    }
+    double const gap_compress_ns(elapsed_ns(start));
+
+    match_list_t matches;
+    size_t gap_size(0);
+    start = std::chrono::steady_clock::now();
+    for (buffer_t const& list : gap_lists) {
+        matches = list_codec.decompress(list);
+        gap_size += list.size();
+    }
+    double const gap_decompress_ns(elapsed_ns(start));
+
+    std::mt19937 generator(3);
+    std::uniform_int_distribution<uint32_t> index(0, LIST_COUNT - 1);
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i(0); i < ACCESS_COUNT; ++i) {
+        uint32_t const list(index(generator));
+        codec.decompress_list(compressed, list, matches);
+        if (!(matches == lists[list])) {
+            throw std::runtime_error("Codec error.");
+        }
     }
-private:
-    uint32_t bits_per_symbol;
-};
+    double const access_ns(elapsed_ns(start));
+
+    std::cout << match_count
+        << "," << double(compressed.size()) / LIST_COUNT
+        << "," << double(gap_size) / LIST_COUNT
+        << "," << multi_compress_ns / LIST_COUNT
+        << "," << gap_compress_ns / LIST_COUNT
+        << "," << multi_decompress_ns / LIST_COUNT
+        << "," << gap_decompress_ns / LIST_COUNT
+        << "," << access_ns / ACCESS_COUNT
+        << "\n";
+}
 // ----------------------------------------------------------------------------
-class bzip2_codec
+template<typename Codec>
+void run_test_batch(batch_compressor<Codec>& compressor, uint32_t match_count)
 {
-public:
-    bzip2_codec(uint32_t bits_per_symbol) : bits_per_symbol(bits_per_symbol) {}
-
-    buffer_t compress(match_list_t const& matches)
-    {
-        match_symbols_t symbols(make_symbols(matches, bits_per_symbol));
-
-        uint32_t compressed_size = symbols.size() * 2;
-        buffer_t compressed(compressed_size);
-
-        int err = BZ2_bzBuffToBuffCompress((char*)&compressed[0]
-            , &compressed_size
-            , (char*)&symbols[0]
-            , symbols.size()
-            , 9
-            , 0
-            , 30);
-        if (err != BZ_OK) {
-            throw std::runtime_error("Compression error.");
-        }
+    uint32_t const LIST_COUNT(256);
 
-        compressed.resize(compressed_size);
-        return compressed;
+    std::vector<match_list_t> lists;
+    for (uint32_t i(0); i < LIST_COUNT; ++i) {
+        lists.push_back(make_random_matches(match_count));
     }
 
-    match_list_t decompress(buffer_t& compressed)
-    {
-        match_symbols_t symbols(symbol_count(bits_per_symbol));
+    compressed_batch batch;
+    compressor.compress(lists, batch);
 
-        uint32_t decompressed_size = symbols.size();
-        int err = BZ2_bzBuffToBuffDecompress((char*)&symbols[0]
-            , &decompressed_size
-            , (char*)&compressed[0]
-            , compressed.size()
-            , 0
-            , 0);
-        if (err != BZ_OK) {
-            throw std::runtime_error("Compression error.");
-        }
-        if (decompressed_size != symbols.size()) {
-            throw std::runtime_error("Size mismatch.");
-        }
+    std::vector<match_list_t> decompressed;
+    compressor.decompress(batch, decompressed);
+    if (!(lists == decompressed)) {
+        throw std::runtime_error("Codec error.");
+    }
 
-        return make_matches(symbols, bits_per_symbol);
+    double sum(static_cast<double>(batch.offsets.back()));
+    std::cout << match_count << "," << (sum / LIST_COUNT) << "\n";
+}
+// ============================================================================
+// Symbols below `symbol_count`, mostly small ones
+std::vector<uint32_t> make_random_symbols(uint32_t symbol_count, size_t count)
+{
+    static std::mt19937 generator(1);
+    std::geometric_distribution<uint32_t> distribution(0.3);
+    std::vector<uint32_t> symbols(count);
+    for (uint32_t& symbol : symbols) {
+        symbol = std::min(distribution(generator), symbol_count - 1);
     }
-private:
-    uint32_t bits_per_symbol;
-};
+    return symbols;
+}
 // ----------------------------------------------------------------------------
-class snappy_codec
+template<typename Model>
+void encode_symbol(arithmetic_codec& encoder, Model& model, uint32_t symbol)
 {
-public:
-    snappy_codec(uint32_t bits_per_symbol) : bits_per_symbol(bits_per_symbol) {}
-
-    buffer_t compress(match_list_t const& matches)
-    {
-        match_symbols_t symbols(make_symbols(matches, bits_per_symbol));
-
-        size_t compressed_size = snappy_max_compressed_length(symbols.size());
-        buffer_t compressed(compressed_size);
-
-        snappy_status err = snappy_compress((char const*)&symbols[0]
-            , symbols.size()
-            , (char*)&compressed[0]
-            , &compressed_size);
-
-        if (err != SNAPPY_OK) {
-            throw std::runtime_error("Decompression error.");
-        }
-
-        compressed.resize(compressed_size);
-        return compressed;
+    encoder.encode(symbol, model);
+}
+// ----------------------------------------------------------------------------
+template<typename Model>
+uint32_t decode_symbol(arithmetic_codec& decoder, Model& model)
+{
+    return decoder.decode(model);
+}
+// ----------------------------------------------------------------------------
+// Symbols not seen yet are escaped and follow in 8 bits, as in ppm_model
+void encode_symbol(arithmetic_codec& encoder, adaptive_esc_data_model& model, uint32_t symbol)
+{
+    if (model.has_symbol(symbol)) {
+        encoder.encode(symbol, model);
+    } else {
+        encoder.encode(model.get_escape(), model);
+        encoder.put_bits(symbol, 8);
+        model.add_symbol(symbol);
     }
-
-    match_list_t decompress(buffer_t& compressed)
-    {
-        match_symbols_t symbols(symbol_count(bits_per_symbol));
-
-        size_t decompressed_size(symbols.size());
-        snappy_status err = snappy_uncompress((char const*)&compressed[0]
-            , compressed.size()
-            , (char*)&symbols[0]
-            , &decompressed_size);
-
-        if (err != SNAPPY_OK) {
-            throw std::runtime_error("Decompression error.");
-        }
-
-        return make_matches(symbols, bits_per_symbol);
+}
+// ----------------------------------------------------------------------------
+uint32_t decode_symbol(arithmetic_codec& decoder, adaptive_esc_data_model& model)
+{
+    uint32_t symbol(decoder.decode(model));
+    if (model.is_escape(symbol)) {
+        symbol = decoder.get_bits(8);
+        model.add_symbol(symbol);
     }
-private:
-    uint32_t bits_per_symbol;
-};
-// ============================================================================
-void run_estimate(uint32_t match_count)
+    return symbol;
+}
+// ----------------------------------------------------------------------------
+template<typename Model>
+buffer_t encode_symbols(Model& model, std::vector<uint32_t> const& symbols)
 {
-    std::vector<uint32_t> est_size;
-
-    uint32_t const ITER_COUNT(16);
-    for (uint32_t i(0); i < ITER_COUNT; ++i) {
-        match_list_t matches = make_random_matches(match_count);
-
-        est_size.push_back(estimate_size(matches));
+    buffer_t code(symbols.size() * 4 + 16);
+    arithmetic_codec encoder(static_cast<uint32_t>(code.size()), code.data());
+    encoder.start_encoder();
+    for (uint32_t symbol : symbols) {
+        encode_symbol(encoder, model, symbol);
     }
-
-    if (std::set<uint32_t>(est_size.begin(), est_size.end()).size() != 1) {
-        throw std::runtime_error("This shoudn't happen.");
+    code.resize(encoder.stop_encoder());
+    return code;
+}
+// ----------------------------------------------------------------------------
+template<typename Model>
+std::vector<uint32_t> decode_symbols(Model& model, buffer_t& code, size_t count)
+{
+    arithmetic_codec decoder(static_cast<uint32_t>(std::max<size_t>(code.size(), 3)), code.data());
+    decoder.start_decoder();
+    std::vector<uint32_t> symbols(count);
+    for (uint32_t& symbol : symbols) {
+        symbol = decode_symbol(decoder, model);
     }
-
-    std::cout << match_count << "," << est_size.front() << "\n";
+    decoder.stop_decoder();
+    return symbols;
 }
-// ============================================================================
-template<typename Codec>
-void run_test(Codec& codec, uint32_t match_count)
+// ----------------------------------------------------------------------------
+// `copy` has to decode what `warm` codes next, decoder tables included
+template<typename Model>
+void check_restored(Model& warm, Model& copy, std::vector<uint32_t> const& symbols)
 {
-    std::vector<uint32_t> comp_size;
-
-    uint32_t const ITER_COUNT(16);
-    for (uint32_t i(0); i < ITER_COUNT; ++i) {
-        match_list_t matches = make_random_matches(match_count);
-
-        buffer_t compressed = codec.compress(matches);
-        comp_size.push_back(static_cast<uint32_t>(compressed.size()));
-
-        match_list_t decompressed = codec.decompress(compressed);
-        if (!(matches == decompressed)) {
-            throw std::runtime_error("Codec error.");
-        }
+    buffer_t code(encode_symbols(warm, symbols));
+    if (decode_symbols(copy, code, symbols.size()) != symbols) {
+        throw std::runtime_error("Snapshot error.");
     }
-
-    double sum = std::accumulate(comp_size.begin(), comp_size.end(), uint32_t(0));
-    std::cout << match_count << "," << (sum / ITER_COUNT) << "\n";
+}
+// ----------------------------------------------------------------------------
+template<typename Model>
+void run_test_snapshot(char const* name, Model& warm, Model& copy, std::vector<uint32_t> const& symbols)
+{
+    buffer_t snapshot(warm.snapshot_size());
+    warm.snapshot(snapshot.data());
+    if (copy.restore(snapshot.data(), snapshot.size()) != snapshot.size()) {
+        throw std::runtime_error("Snapshot error.");
+    }
+    check_restored(warm, copy, symbols);
+    std::cout << name << "," << snapshot.size() << "\n";
 }
 // ============================================================================
 void run_tests_zlib()
@@ -492,6 +362,119 @@ void run_tests_arith_v1()
     }
 }
 
+void run_tests_gap()
+{
+    gap_codec codec;
+    std::vector<uint32_t> test_sizes = gen_test_sizes();
+    for (auto n : test_sizes) {
+        run_test(codec, n);
+    }
+}
+
+void run_tests_interleaved()
+{
+    interleaved_codec codec(4);
+    std::vector<uint32_t> test_sizes = gen_test_sizes();
+    for (auto n : test_sizes) {
+        run_test(codec, n);
+    }
+}
+
+void run_tests_segmented()
+{
+    thread_pool pool;
+    segmented_codec codec(static_cast<uint32_t>(4 * pool.size()), &pool);
+    std::vector<uint32_t> test_sizes = gen_test_sizes();
+    for (auto n : test_sizes) {
+        run_test(codec, n);
+    }
+}
+
+void run_tests_delta()
+{
+    // Versions overlapping by about 95%
+    delta_codec codec;
+    std::vector<uint32_t> test_sizes = gen_test_sizes();
+    for (auto n : test_sizes) {
+        run_test_delta(codec, n, 0.05);
+    }
+}
+
+void run_tests_multi_list()
+{
+    // Smaller blocks trade size for cheaper single lists
+    std::vector<uint32_t> test_sizes = { 1, 10, 30, 60, 100, 300, 1000 };
+    for (uint32_t lists_per_block : { 16, 64, 256 }) {
+        multi_list_codec codec(lists_per_block);
+        std::cout << "lists_per_block " << lists_per_block << "\n";
+        for (auto n : test_sizes) {
+            run_test_multi_list(codec, n);
+        }
+    }
+}
+
+void run_tests_batch_arith_v2()
+{
+    thread_pool pool;
+    batch_compressor<arithmetic_codec_v2> compressor(pool);
+    std::vector<uint32_t> test_sizes = gen_test_sizes();
+    for (auto n : test_sizes) {
+        run_test_batch(compressor, n);
+    }
+}
+
+void run_tests_model_snapshot()
+{
+    uint32_t const SYMBOL_COUNT(40);
+    std::vector<uint32_t> const warmup(make_random_symbols(SYMBOL_COUNT, 5000));
+    std::vector<uint32_t> const symbols(make_random_symbols(SYMBOL_COUNT, 1000));
+    auto to_bits = [](std::vector<uint32_t> bits) {
+        for (uint32_t& bit : bits) {
+            bit = (bit == 0) ? 1 : 0;
+        }
+        return bits;
+    };
+
+    std::vector<double> probability(SYMBOL_COUNT);
+    for (uint32_t s(0); s < SYMBOL_COUNT; ++s) {
+        probability[s] = 0.3 * std::pow(0.7, s) + 0.0005;
+    }
+    double const total(std::accumulate(probability.begin(), probability.end(), 0.0));
+    for (double& p : probability) {
+        p /= total;
+    }
+    static_data_model static_warm(SYMBOL_COUNT, probability.data());
+    static_data_model static_copy;
+    run_test_snapshot("static_data_model", static_warm, static_copy, symbols);
+
+    adaptive_data_model data_warm(SYMBOL_COUNT);
+    adaptive_data_model data_copy(SYMBOL_COUNT);
+    encode_symbols(data_warm, warmup);
+    run_test_snapshot("adaptive_data_model", data_warm, data_copy, symbols);
+    // Restored from a warmed-up template rather than a snapshot
+    data_copy.restore(data_warm);
+    check_restored(data_warm, data_copy, warmup);
+
+    adaptive_bit_model bit_warm;
+    adaptive_bit_model bit_copy;
+    encode_symbols(bit_warm, to_bits(warmup));
+    run_test_snapshot("adaptive_bit_model", bit_warm, bit_copy, to_bits(symbols));
+
+    // The escape symbol is the last one
+    adaptive_esc_data_model esc_warm(SYMBOL_COUNT + 1);
+    adaptive_esc_data_model esc_copy(SYMBOL_COUNT + 1);
+    encode_symbols(esc_warm, warmup);
+    run_test_snapshot("adaptive_esc_data_model", esc_warm, esc_copy, symbols);
+
+    // On memory the caller owns, as the PPM contexts are, which restoring
+    // keeps using
+    std::vector<uint32_t> memory(adaptive_esc_data_model::memory_words(SYMBOL_COUNT + 1));
+    adaptive_esc_data_model esc_user;
+    esc_user.set_alphabet(SYMBOL_COUNT + 1, memory.data());
+    run_test_snapshot("adaptive_esc_data_model (user memory)", esc_warm, esc_user, warmup);
+    esc_user.restore(esc_warm);
+    check_restored(esc_warm, esc_user, symbols);
+}
 
 int main()
 {